@@ -72,6 +72,28 @@ describe('Function', () => {
       });
     });
   });
+
+  describe('palettesJson', async () => {
+    const palettes = JSON.parse(cdata.palettesJson('wled00/palettes.h')).p;
+
+    it('should contain all built-in palettes', async () => {
+      const gradientCount = parseInt(fs.readFileSync('wled00/const.h', 'utf-8').match(/#define GRADIENT_PALETTE_COUNT (\d+)/)[1]);
+      assert.strictEqual(Object.keys(palettes).length, 13 + gradientCount);
+    });
+
+    it('should contain gradient stops up to index 255', async () => {
+      assert.deepStrictEqual(palettes[31], [[0, 194, 1, 1], [94, 1, 29, 18], [132, 57, 131, 28], [255, 113, 1, 1]]); // ib_jul01_gp
+      for (let i = 13; i < Object.keys(palettes).length; i++) {
+        assert.strictEqual(palettes[i][palettes[i].length - 1][0], 255, 'palette ' + i);
+      }
+    });
+
+    it('should throw an exception if the file does not exist', async () => {
+      assert.throws(() => {
+        cdata.palettesJson('nonexistent.h');
+      });
+    });
+  });
 });
 
 describe('Script', () => {
@@ -24,9 +24,9 @@ const minifyHtml = require("html-minifier-terser").minify;
 const packageJson = require("../package.json");
 
 // Export functions for testing
-module.exports = { isFileNewerThan, isAnyFileInFolderNewerThan };
+module.exports = { isFileNewerThan, isAnyFileInFolderNewerThan, palettesJson };
 
-const output = ["wled00/html_ui.h", "wled00/html_pixart.h", "wled00/html_cpal.h", "wled00/html_pxmagic.h", "wled00/html_settings.h", "wled00/html_other.h"]
+const output = ["wled00/html_ui.h", "wled00/html_pixart.h", "wled00/html_cpal.h", "wled00/html_pxmagic.h", "wled00/html_settings.h", "wled00/html_other.h", "wled00/html_palettes.h"]
 
 // \x1b[34m is blue, \x1b[36m is cyan, \x1b[0m is reset
 const wledBanner = `
@@ -187,6 +187,70 @@ async function writeChunks(srcDir, specs, resultFile) {
   fs.writeFileSync(resultFile, src);
 }
 
+// FastLED built-in palettes (CRGBPalette16) used by WLED palettes 0-12, see serializePalettes() in json.cpp
+const fastLEDPalettes = {
+  Party:   [0x5500AB, 0x84007C, 0xB5004B, 0xE5001B, 0xE81700, 0xB84700, 0xAB7700, 0xABAB00, 0xAB5500, 0xDD2200, 0xF2000E, 0xC2003E, 0x8F0071, 0x5F00A1, 0x2F00D0, 0x0007F9],
+  Cloud:   [0x0000FF, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x00008B, 0x0000FF, 0x00008B, 0x87CEEB, 0x87CEEB, 0xADD8E6, 0xFFFFFF, 0xADD8E6, 0x87CEEB],
+  Lava:    [0x000000, 0x800000, 0x000000, 0x800000, 0x8B0000, 0x8B0000, 0x800000, 0x8B0000, 0x8B0000, 0x8B0000, 0xFF0000, 0xFFA500, 0xFFFFFF, 0xFFA500, 0xFF0000, 0x8B0000],
+  Ocean:   [0x191970, 0x00008B, 0x191970, 0x000080, 0x00008B, 0x0000CD, 0x2E8B57, 0x008080, 0x5F9EA0, 0x0000FF, 0x008B8B, 0x6495ED, 0x7FFFD4, 0x2E8B57, 0x00FFFF, 0x87CEFA],
+  Forest:  [0x006400, 0x006400, 0x556B2F, 0x006400, 0x008000, 0x228B22, 0x6B8E23, 0x008000, 0x2E8B57, 0x66CDAA, 0x32CD32, 0x9ACD32, 0x90EE90, 0x7CFC00, 0x66CDAA, 0x228B22],
+  Rainbow: [0xFF0000, 0xD52A00, 0xAB5500, 0xAB7F00, 0xABAB00, 0x56D500, 0x00FF00, 0x00D52A, 0x00AB55, 0x0056AA, 0x0000FF, 0x2A00D5, 0x5500AB, 0x7F0081, 0xAB0055, 0xD5002B],
+  RainbowStripe: [0xFF0000, 0x000000, 0xAB5500, 0x000000, 0xABAB00, 0x000000, 0x00FF00, 0x000000, 0x00AB55, 0x000000, 0x0000FF, 0x000000, 0x5500AB, 0x000000, 0xAB0055, 0x000000],
+};
+
+// Builds JSON of built-in palettes (same as /json/palx) from palettes.h so that UI can fetch it once and cache it
+function palettesJson(sourceFile) {
+  const src = fs.readFileSync(sourceFile, "utf-8").replace(/\/\*[\s\S]*?\*\//g, "").replace(/\/\/.*$/gm, "");
+  const gradients = {};
+  for (const m of src.matchAll(/const\s+byte\s+(\w+)\[\]\s+PROGMEM\s*=\s*\{([^}]*)\}/g)) {
+    gradients[m[1]] = m[2].split(",").map((v) => parseInt(v.trim())).filter((v) => !isNaN(v));
+  }
+  const list = src.match(/gGradientPalettes\[\]\s+PROGMEM\s*=\s*\{([^}]*)\}/)[1].split(",").map((v) => v.trim()).filter((v) => v);
+
+  const pal16 = (p) => p.map((c, i) => [i << 4, (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF]);
+  const p = {
+    0: pal16(fastLEDPalettes.Party),
+    1: ["r", "r", "r", "r"],
+    2: ["c1"],
+    3: ["c1", "c1", "c2", "c2"],
+    4: ["c3", "c2", "c1"],
+    5: ["c1", "c1", "c1", "c1", "c1", "c2", "c2", "c2", "c2", "c2", "c3", "c3", "c3", "c3", "c3", "c1"],
+    6: pal16(fastLEDPalettes.Party),
+    7: pal16(fastLEDPalettes.Cloud),
+    8: pal16(fastLEDPalettes.Lava),
+    9: pal16(fastLEDPalettes.Ocean),
+    10: pal16(fastLEDPalettes.Forest),
+    11: pal16(fastLEDPalettes.Rainbow),
+    12: pal16(fastLEDPalettes.RainbowStripe),
+  };
+  list.forEach((name, i) => {
+    const g = gradients[name];
+    if (!g) throw new Error("Gradient palette " + name + " not found in " + sourceFile);
+    const stops = [];
+    for (let j = 0; j + 3 < g.length; j += 4) {
+      stops.push(g.slice(j, j + 4));
+      if (g[j] == 255) break;
+    }
+    p[13 + i] = stops;
+  });
+  return JSON.stringify({ p: p });
+}
+
+function writePalettes(sourceFile, resultFile) {
+  console.info("Reading " + sourceFile);
+  const json = palettesJson(sourceFile);
+  const zip = zlib.gzipSync(json, { level: zlib.constants.Z_BEST_COMPRESSION });
+  const hash = require("node:crypto").createHash("sha1").update(json).digest().readUInt16BE(0); // used as ETag suffix
+  console.info("Compressed palettes from " + json.length + " to " + zip.length + " bytes");
+  let src = multiHeader;
+  src += `\n// Autogenerated from ${sourceFile}, do not edit!!\n`;
+  src += `const uint16_t JSON_palettes_hash = 0x${hash.toString(16).padStart(4, "0")};\n`;
+  src += `const uint16_t JSON_palettes_length = ${zip.length};\n`;
+  src += `const uint8_t JSON_palettes[] PROGMEM = {\n${hexdump(zip)}\n};\n\n`;
+  console.info("Writing " + resultFile);
+  fs.writeFileSync(resultFile, src);
+}
+
 // Check if a file is newer than a given time
 function isFileNewerThan(filePath, time) {
   const stats = fs.statSync(filePath);
@@ -222,7 +286,8 @@ function isAlreadyBuilt(webUIPath, packageJsonPath = "package.json") {
     }
   }
 
-  return !isAnyFileInFolderNewerThan(webUIPath, lastBuildTime) && !isFileNewerThan(packageJsonPath, lastBuildTime) && !isFileNewerThan(__filename, lastBuildTime);
+  return !isAnyFileInFolderNewerThan(webUIPath, lastBuildTime) && !isFileNewerThan(packageJsonPath, lastBuildTime) && !isFileNewerThan(__filename, lastBuildTime)
+    && !isFileNewerThan("wled00/palettes.h", lastBuildTime);
 }
 
 // Don't run this script if we're in a test environment
@@ -241,6 +306,7 @@ writeHtmlGzipped("wled00/data/index.htm", "wled00/html_ui.h", 'index');
 writeHtmlGzipped("wled00/data/pixart/pixart.htm", "wled00/html_pixart.h", 'pixart');
 writeHtmlGzipped("wled00/data/cpal/cpal.htm", "wled00/html_cpal.h", 'cpal');
 writeHtmlGzipped("wled00/data/pxmagic/pxmagic.htm", "wled00/html_pxmagic.h", 'pxmagic');
+writePalettes("wled00/palettes.h", "wled00/html_palettes.h");
 
 writeChunks(
   "wled00/data",
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "wled.h"
+#include "OneWire.h"
+
+/*
+ * 1-Wire transports used by the Temperature usermod
+ *
+ * Operations are started with reset() or transfer() and completed by calling poll() until it
+ * no longer returns OW_BUSY, so that a whole sensor transaction can be spread across loop() calls.
+ *
+ * OneWireUART (ESP32) lets a UART generate the 1-Wire slots with TX and RX routed to the same
+ * open-drain pin (bus pull-up still required). A reset is 0xF0 at 9600 baud (presence detected
+ * if it is not read back unchanged), each bit slot is one byte at 115200 baud: 0xFF writes 1 or
+ * reads a bit (read back as 0xFF if sensor sent 1), 0x00 writes 0. Timing is done by the UART
+ * hardware so interrupts are never masked and LED output is not disturbed during readings.
+ *
+ * OneWireBitBang uses the OneWire library (ESP8266, parasite power or if no UART is available).
+ * It completes each operation immediately and masks interrupts during every bit slot.
+ */
+
+#define OW_BUSY      0
+#define OW_DONE      1
+#define OW_ERROR     2
+
+#define OW_MAX_BYTES 20   // longest transfer: match ROM (9) + read scratchpad (1) + scratchpad (9)
+
+class OneWireTransport {
+  public:
+    virtual ~OneWireTransport() {}
+    virtual bool    begin(int8_t pin) = 0;
+    virtual void    reset() = 0;                                                  // starts reset pulse & presence detection
+    virtual void    transfer(const uint8_t *tx, size_t len, bool power = false) = 0; // starts transfer, 0xFF bytes are read from bus
+    virtual uint8_t poll() = 0;                                                   // OW_BUSY until operation is complete
+    virtual bool    usesInterrupts() const = 0;                                   // true if bit slots mask interrupts
+
+    inline bool           presence() const { return _presence; }
+    inline const uint8_t *data() const     { return _rx; }                        // bytes received by last transfer()
+
+    // blocking ROM search (only used during setup), returns number of devices found
+    uint8_t search(uint8_t (*addr)[8], uint8_t maxDevices) {
+      uint8_t rom[8] = {0};
+      uint8_t found = 0;
+      int lastDiscrepancy = -1;
+      do {
+        reset();
+        if (wait() != OW_DONE || !_presence) break;
+        const uint8_t cmd = 0xF0; // search ROM
+        transfer(&cmd, 1);
+        if (wait() != OW_DONE) break;
+        int discrepancy = -1;
+        for (int i = 0; i < 64; i++) {
+          bool b  = touchBit(true);
+          bool cb = touchBit(true);
+          if (b && cb) return found; // no device responded
+          bool dir = b;
+          if (b == cb) { // devices with both 0 and 1 at this position
+            dir = i < lastDiscrepancy ? (rom[i>>3] >> (i&7)) & 1 : i == lastDiscrepancy;
+            if (!dir) discrepancy = i;
+          }
+          if (dir) rom[i>>3] |= 1 << (i&7);
+          else     rom[i>>3] &= ~(1 << (i&7));
+          touchBit(dir);
+        }
+        lastDiscrepancy = discrepancy;
+        if (OneWire::crc8(rom, 7) == rom[7]) memcpy(addr[found++], rom, 8);
+      } while (lastDiscrepancy >= 0 && found < maxDevices);
+      return found;
+    }
+
+  protected:
+    uint8_t _rx[OW_MAX_BYTES];
+    bool    _presence = false;
+
+    virtual bool touchBit(bool b) = 0; // blocking single bit slot, returns bit read
+
+    uint8_t wait() {
+      uint8_t r;
+      while ((r = poll()) == OW_BUSY) yield();
+      return r;
+    }
+};
+
+class OneWireBitBang : public OneWireTransport {
+  public:
+    ~OneWireBitBang() { delete _ow; }
+
+    bool begin(int8_t pin) override {
+      _ow = new OneWire(pin);
+      return _ow != nullptr;
+    }
+    void reset() override { _presence = _ow->reset(); }
+    void transfer(const uint8_t *tx, size_t len, bool power) override {
+      for (size_t i = 0; i < len && i < OW_MAX_BYTES; i++) {
+        if (tx[i] == 0xFF) _rx[i] = _ow->read();
+        else {
+          _ow->write(tx[i], power && i == len-1); // keep bus powered after last byte (parasite power)
+          _rx[i] = tx[i];
+        }
+      }
+    }
+    uint8_t poll() override { return OW_DONE; }
+    bool usesInterrupts() const override { return true; }
+
+  protected:
+    bool touchBit(bool b) override {
+      if (b) return _ow->read_bit();
+      _ow->write_bit(0);
+      return false;
+    }
+
+  private:
+    OneWire *_ow = nullptr;
+};
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <driver/uart.h>
+#include <soc/gpio_sig_map.h>
+
+#ifndef TEMPERATURE_UART
+  #define TEMPERATURE_UART 1  // UART0 is used by Serial, UART2 by DMX output
+#endif
+#if TEMPERATURE_UART == 2
+  #define OW_UART_TX_IDX U2TXD_OUT_IDX
+#else
+  #define OW_UART_TX_IDX U1TXD_OUT_IDX
+#endif
+#define OW_UART_TIMEOUT 20    // ms, longest transfer takes ~14ms
+
+class OneWireUART : public OneWireTransport {
+  public:
+    ~OneWireUART() {
+      if (_pin >= 0) pinMatrixOutDetach(_pin, false, false);
+      if (_installed) uart_driver_delete((uart_port_t)TEMPERATURE_UART);
+    }
+
+    bool begin(int8_t pin) override {
+      uart_config_t cfg = {};
+      cfg.baud_rate = 9600;
+      cfg.data_bits = UART_DATA_8_BITS;
+      cfg.parity    = UART_PARITY_DISABLE;
+      cfg.stop_bits = UART_STOP_BITS_1;
+      cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+      // buffers larger than the FIFO, so a whole transfer is queued without blocking
+      if (uart_driver_install((uart_port_t)TEMPERATURE_UART, 256, 256, 0, nullptr, 0) != ESP_OK) return false;
+      _installed = true;
+      if (uart_param_config((uart_port_t)TEMPERATURE_UART, &cfg) != ESP_OK ||
+          uart_set_pin((uart_port_t)TEMPERATURE_UART, pin, pin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) return false;
+      // TX and RX share the pin: switch it to open drain (this detaches TX) and re-attach TX
+      gpio_set_pull_mode((gpio_num_t)pin, GPIO_PULLUP_ONLY);
+      gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);
+      pinMatrixOutAttach(pin, OW_UART_TX_IDX, false, false);
+      _pin = pin;
+      return true;
+    }
+
+    void reset() override {
+      start(9600, 1);
+      _buf[0] = 0xF0;
+      uart_write_bytes((uart_port_t)TEMPERATURE_UART, (const char*)_buf, 1);
+      _reset = true;
+    }
+
+    void transfer(const uint8_t *tx, size_t len, bool power) override {
+      _len = min(len, (size_t)OW_MAX_BYTES);
+      start(115200, _len * 8);
+      for (size_t i = 0; i < _len; i++) for (unsigned b = 0; b < 8; b++) _buf[i*8 + b] = (tx[i] >> b) & 1 ? 0xFF : 0x00; // LSB first
+      uart_write_bytes((uart_port_t)TEMPERATURE_UART, (const char*)_buf, _expected);
+      _reset = false;
+    }
+
+    uint8_t poll() override {
+      if (!_expected) return OW_DONE;
+      size_t avail = 0;
+      uart_get_buffered_data_len((uart_port_t)TEMPERATURE_UART, &avail);
+      if (avail < _expected) {
+        if (millis() - _start < OW_UART_TIMEOUT) return OW_BUSY;
+        _expected = 0;
+        _presence = false;
+        return OW_ERROR; // no echo: pin not connected to UART or bus held low
+      }
+      uart_read_bytes((uart_port_t)TEMPERATURE_UART, _buf, _expected, 0);
+      if (_reset) _presence = _buf[0] != 0xF0;
+      else for (size_t i = 0; i < _len; i++) {
+        _rx[i] = 0;
+        for (unsigned b = 0; b < 8; b++) if (_buf[i*8 + b] == 0xFF) _rx[i] |= 1 << b;
+      }
+      _expected = 0;
+      return OW_DONE;
+    }
+
+    bool usesInterrupts() const override { return false; }
+
+  protected:
+    bool touchBit(bool b) override {
+      start(115200, 1);
+      _buf[0] = b ? 0xFF : 0x00;
+      uart_write_bytes((uart_port_t)TEMPERATURE_UART, (const char*)_buf, 1);
+      _len = 0;
+      _reset = false;
+      return wait() == OW_DONE && _buf[0] == 0xFF;
+    }
+
+  private:
+    int8_t        _pin = -1;
+    bool          _installed = false;
+    bool          _reset = false;
+    size_t        _len = 0;
+    size_t        _expected = 0;
+    unsigned long _start = 0;
+    uint8_t       _buf[OW_MAX_BYTES*8];
+
+    void start(uint32_t baud, size_t expected) {
+      uart_flush_input((uart_port_t)TEMPERATURE_UART);
+      uart_set_baudrate((uart_port_t)TEMPERATURE_UART, baud);
+      _expected = expected;
+      _start = millis();
+    }
+};
+#endif
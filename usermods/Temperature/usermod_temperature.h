@@ -1,7 +1,7 @@
 #pragma once
 
 #include "wled.h"
-#include "OneWire.h"
+#include "onewire_transport.h"
 
 //Pin defaults for QuinLed Dig-Uno if not overriden
 #ifndef TEMPERATURE_PIN
@@ -17,6 +17,11 @@
 #define USERMOD_DALLASTEMPERATURE_MEASUREMENT_INTERVAL 60000
 #endif
 
+// max number of sensors on the bus (first one is the main temperature)
+#ifndef TEMPERATURE_MAX_SENSORS
+#define TEMPERATURE_MAX_SENSORS 4
+#endif
+
 static uint16_t mode_temperature();
 
 class UsermodTemperature : public Usermod {
@@ -24,7 +29,7 @@ class UsermodTemperature : public Usermod {
   private:
 
     bool initDone = false;
-    OneWire *oneWire;
+    OneWireTransport *oneWire = nullptr;
     // GPIO pin used for sensor (with a default compile-time fallback)
     int8_t temperaturePin = TEMPERATURE_PIN;
     // measurement unit (true==°C, false==°F)
@@ -36,16 +41,20 @@ class UsermodTemperature : public Usermod {
     unsigned long readingInterval = USERMOD_DALLASTEMPERATURE_MEASUREMENT_INTERVAL;
     // set last reading as "40 sec before boot", so first reading is taken after 20 sec
     unsigned long lastMeasurement = UINT32_MAX - USERMOD_DALLASTEMPERATURE_MEASUREMENT_INTERVAL;
-    // last time requestTemperatures was called
+    // last time conversion was requested
     // used to determine when we can read the sensors temperature
-    // we have to wait at least 93.75 ms after requestTemperatures() is called
+    // we have to wait at least 93.75 ms after conversion is requested
     unsigned long lastTemperaturesRequest;
     float temperature;
-    // indicates requestTemperatures has been called but the sensor measurement is not complete
-    bool waitingForConversion = false;
-    // flag set at startup if DS18B20 sensor not found, avoids trying to keep getting
+    // step of the measurement in progress (each step is one non-blocking bus operation)
+    enum : uint8_t { TS_IDLE, TS_CONVERT_RESET, TS_CONVERT, TS_WAIT, TS_READ_RESET, TS_READ } state = TS_IDLE;
+    // set at startup to number of DS18xxx sensors found, avoids trying to keep getting
     // temperature if flashed to a board without a sensor attached
-    byte sensorFound;
+    uint8_t sensorFound = 0;
+    uint8_t sensorAddr[TEMPERATURE_MAX_SENSORS][8];
+    float   sensorTemp[TEMPERATURE_MAX_SENSORS];
+    uint8_t currentSensor = 0;
+    uint8_t errorCount = 0;
 
     bool enabled = true;
 
@@ -64,12 +73,12 @@ class UsermodTemperature : public Usermod {
     static const char _Temperature[];
     static const char _data_fx[];
     
-    //Dallas sensor quick (& dirty) reading. Credit to - Author: Peter Scargill, August 17th, 2013
-    float readDallas();
-    void requestTemperatures();
+    float decodeDallas(const uint8_t *data, uint8_t family);
+    void readScratchpad();
     void readTemperature();
     bool findSensor();
 #ifndef WLED_DISABLE_MQTT
+    void publishTemperature();
     void publishHomeAssistantAutodiscovery();
 #endif
 
@@ -110,56 +119,57 @@ class UsermodTemperature : public Usermod {
 };
 
 //Dallas sensor quick (& dirty) reading. Credit to - Author: Peter Scargill, August 17th, 2013
-float UsermodTemperature::readDallas() {
-  byte data[9];
+float UsermodTemperature::decodeDallas(const uint8_t *data, uint8_t family) {
   int16_t result;                         // raw data from sensor
   float retVal = -127.0f;
-  if (oneWire->reset()) {                 // if reset() fails there are no OneWire devices
-    oneWire->skip();                      // skip ROM
-    oneWire->write(0xBE);                 // read (temperature) from EEPROM
-    oneWire->read_bytes(data, 9);         // first 2 bytes contain temperature
+  if (OneWire::crc8(data,8) != data[8]) { // also catches missing sensor (all 0xFF)
+    DEBUG_PRINTLN(F("CRC error reading temperature."));
     #ifdef WLED_DEBUG
-    if (OneWire::crc8(data,8) != data[8]) {
-      DEBUG_PRINTLN(F("CRC error reading temperature."));
-      for (unsigned i=0; i < 9; i++) DEBUG_PRINTF_P(PSTR("0x%02X "), data[i]);
-      DEBUG_PRINT(F(" => "));
-      DEBUG_PRINTF_P(PSTR("0x%02X\n"), OneWire::crc8(data,8));
-    }
+    for (unsigned i=0; i < 9; i++) DEBUG_PRINTF_P(PSTR("0x%02X "), data[i]);
+    DEBUG_PRINTF_P(PSTR(" => 0x%02X\n"), OneWire::crc8(data,8));
     #endif
-    switch(sensorFound) {
-      case 0x10:  // DS18S20 has 9-bit precision
-        result = (data[1] << 8) | data[0];
-        retVal = float(result) * 0.5f;
-        break;
-      case 0x22:  // DS18B20
-      case 0x28:  // DS1822
-      case 0x3B:  // DS1825
-      case 0x42:  // DS28EA00
-        result = (data[1]<<4) | (data[0]>>4);   // we only need whole part, we will add fraction when returning
-        if (data[1] & 0x80) result |= 0xF000;   // fix negative value
-        retVal = float(result) + ((data[0] & 0x08) ? 0.5f : 0.0f);
-        break;
-    }
+    return retVal;
+  }
+  switch(family) {
+    case 0x10:  // DS18S20 has 9-bit precision
+      result = (data[1] << 8) | data[0];
+      retVal = float(result) * 0.5f;
+      break;
+    case 0x22:  // DS18B20
+    case 0x28:  // DS1822
+    case 0x3B:  // DS1825
+    case 0x42:  // DS28EA00
+      result = (data[1]<<4) | (data[0]>>4);   // we only need whole part, we will add fraction when returning
+      if (data[1] & 0x80) result |= 0xF000;   // fix negative value
+      retVal = float(result) + ((data[0] & 0x08) ? 0.5f : 0.0f);
+      break;
   }
-  for (unsigned i=1; i<9; i++) data[0] &= data[i];
-  return data[0]==0xFF ? -127.0f : retVal;
+  uint8_t all = data[0];
+  for (unsigned i=1; i<9; i++) all &= data[i];
+  return all==0xFF ? -127.0f : retVal;
 }
 
-void UsermodTemperature::requestTemperatures() {
-  DEBUG_PRINTLN(F("Requesting temperature."));
-  oneWire->reset();
-  oneWire->skip();                        // skip ROM
-  oneWire->write(0x44,parasite);          // request new temperature reading
-  if (parasite && parasitePin >=0 ) digitalWrite(parasitePin, HIGH); // has to happen within 10us (open MOSFET)
-  lastTemperaturesRequest = millis();
-  waitingForConversion = true;
+// starts reading scratchpad of current sensor (bus reset has completed)
+void UsermodTemperature::readScratchpad() {
+  uint8_t cmd[OW_MAX_BYTES];
+  size_t len = 0;
+  if (sensorFound > 1) {
+    cmd[len++] = 0x55;                    // match ROM
+    memcpy(cmd + len, sensorAddr[currentSensor], 8);
+    len += 8;
+  } else {
+    cmd[len++] = 0xCC;                    // skip ROM
+  }
+  cmd[len++] = 0xBE;                      // read scratchpad, first 2 bytes contain temperature
+  memset(cmd + len, 0xFF, 9);             // read 9 bytes
+  len += 9;
+  oneWire->transfer(cmd, len);
 }
 
+// all sensors have been read
 void UsermodTemperature::readTemperature() {
-  if (parasite && parasitePin >=0 ) digitalWrite(parasitePin, LOW); // deactivate power (close MOSFET)
-  temperature = readDallas();
+  temperature = sensorTemp[0];
   lastMeasurement = millis();
-  waitingForConversion = false;
   //DEBUG_PRINTF_P(PSTR("Read temperature %2.1f.\n"), temperature); // does not work properly on 8266
   DEBUG_PRINT(F("Read temperature "));
   DEBUG_PRINTLN(temperature);
@@ -167,28 +177,53 @@ void UsermodTemperature::readTemperature() {
 
 bool UsermodTemperature::findSensor() {
   DEBUG_PRINTLN(F("Searching for sensor..."));
-  uint8_t deviceAddress[8] = {0,0,0,0,0,0,0,0};
-  // find out if we have DS18xxx sensor attached
-  oneWire->reset_search();
-  delay(10);
-  while (oneWire->search(deviceAddress)) {
+  uint8_t devices[TEMPERATURE_MAX_SENSORS][8];
+  uint8_t n = oneWire->search(devices, TEMPERATURE_MAX_SENSORS);
+  // find out if we have DS18xxx sensor(s) attached
+  sensorFound = 0;
+  for (unsigned i = 0; i < n; i++) {
     DEBUG_PRINTLN(F("Found something..."));
-    if (oneWire->crc8(deviceAddress, 7) == deviceAddress[7]) {
-      switch (deviceAddress[0]) {
-        case 0x10:  // DS18S20
-        case 0x22:  // DS18B20
-        case 0x28:  // DS1822
-        case 0x3B:  // DS1825
-        case 0x42:  // DS28EA00
-          DEBUG_PRINTLN(F("Sensor found."));
-          sensorFound = deviceAddress[0];
-          DEBUG_PRINTF_P(PSTR("0x%02X\n"), sensorFound);
-          return true;
-      }
+    switch (devices[i][0]) {
+      case 0x10:  // DS18S20
+      case 0x22:  // DS18B20
+      case 0x28:  // DS1822
+      case 0x3B:  // DS1825
+      case 0x42:  // DS28EA00
+        DEBUG_PRINTF_P(PSTR("Sensor found: 0x%02X\n"), devices[i][0]);
+        memcpy(sensorAddr[sensorFound], devices[i], 8);
+        sensorTemp[sensorFound++] = -127.0f;
+        break;
+    }
+  }
+  if (!sensorFound) DEBUG_PRINTLN(F("Sensor NOT found."));
+  return sensorFound > 0;
+}
+
+#ifndef WLED_DISABLE_MQTT
+void UsermodTemperature::publishTemperature() {
+  if (!WLED_MQTT_CONNECTED) return;
+  char subuf[128];
+  strcpy(subuf, mqttDeviceTopic);
+  if (temperature > -100.0f) {
+    // dont publish super low temperature as the graph will get messed up
+    // the DallasTemperature library returns -127C or -196.6F when problem
+    // reading the sensor
+    strcat_P(subuf, _Temperature);
+    mqtt->publish(subuf, 0, false, String(getTemperatureC()).c_str());
+    strcat_P(subuf, PSTR("_f"));
+    mqtt->publish(subuf, 0, false, String(getTemperatureF()).c_str());
+    if (idx > 0) {
+      StaticJsonDocument <128> msg;
+      msg[F("idx")]    = idx;
+      msg[F("RSSI")]   = WiFi.RSSI();
+      msg[F("nvalue")] = 0;
+      msg[F("svalue")] = String(getTemperatureC());
+      serializeJson(msg, subuf, 127);
+      mqtt->publish("domoticz/in", 0, false, subuf);
     }
+  } else {
+    // publish something else to indicate status?
   }
-  DEBUG_PRINTLN(F("Sensor NOT found."));
-  return false;
 }
 
 #ifndef WLED_DISABLE_MQTT
@@ -216,20 +251,31 @@ void UsermodTemperature::publishHomeAssistantAutodiscovery() {
 #endif
 
 void UsermodTemperature::setup() {
-  int retries = 10;
+  int retries = 3;
   sensorFound = 0;
+  state = TS_IDLE;
   temperature = -127.0f; // default to -127, DS18B20 only goes down to -50C
   if (enabled) {
     // config says we are enabled
     DEBUG_PRINTLN(F("Allocating temperature pin..."));
     // pin retrieved from cfg.json (readFromConfig()) prior to running setup()
     if (temperaturePin >= 0 && PinManager::allocatePin(temperaturePin, true, PinOwner::UM_Temperature)) {
-      oneWire = new OneWire(temperaturePin);
-      if (oneWire->reset()) {
-        while (!findSensor() && retries--) {
-          delay(25); // try to find sensor
+      #ifdef ARDUINO_ARCH_ESP32
+      // parasite power needs the bus driven high right after the convert command, UART cannot do that
+      if (!parasite) {
+        oneWire = new OneWireUART();
+        if (!oneWire->begin(temperaturePin)) {
+          DEBUG_PRINTLN(F("1-Wire UART unavailable."));
+          delete oneWire;
+          oneWire = nullptr;
         }
       }
+      #endif
+      if (!oneWire) {
+        oneWire = new OneWireBitBang();
+        oneWire->begin(temperaturePin);
+      }
+      while (!findSensor() && retries--) yield(); // try to find sensor
       if (parasite && PinManager::allocatePin(parasitePin, true, PinOwner::UM_Temperature)) {
         pinMode(parasitePin, OUTPUT);
         digitalWrite(parasitePin, LOW); // deactivate power (close MOSFET)
@@ -248,61 +294,83 @@ void UsermodTemperature::setup() {
   initDone = true;
 }
 
+// each call advances the measurement by at most one bus operation, nothing waits for the bus
 void UsermodTemperature::loop() {
-  if (!enabled || !sensorFound || strip.isUpdating()) return;
+  if (!enabled || !sensorFound) return;
+  // bit-banged slots mask interrupts, do not interfere with LED output in progress
+  if (oneWire->usesInterrupts() && strip.isUpdating()) return;
 
-  static uint8_t errorCount = 0;
   unsigned long now = millis();
+  uint8_t result = oneWire->poll();
+  if (result == OW_BUSY) return;
+
+  switch (state) {
+    case TS_IDLE:
+      // check to see if we are due for taking a measurement
+      // lastMeasurement will not be updated until all sensors have been read
+      if (now - lastMeasurement < readingInterval) return;
+      DEBUG_PRINTLN(F("Requesting temperature."));
+      oneWire->reset();
+      state = TS_CONVERT_RESET;
+      return;
+    case TS_CONVERT_RESET:
+      if (result == OW_DONE && oneWire->presence()) {
+        const uint8_t cmd[] = {0xCC, 0x44}; // skip ROM (all sensors), request new temperature reading
+        oneWire->transfer(cmd, sizeof(cmd), parasite);
+        if (parasite && parasitePin >=0 ) digitalWrite(parasitePin, HIGH); // has to happen within 10us (open MOSFET)
+        lastTemperaturesRequest = now;
+        state = TS_CONVERT;
+        return;
+      }
+      break; // no sensor responded
+    case TS_CONVERT:
+      state = TS_WAIT;
+      return;
+    case TS_WAIT:
+      // have we waited long enough for conversion?
+      if (now - lastTemperaturesRequest < 750 /* 93.75ms per the datasheet but can be up to 750ms */) return;
+      if (parasite && parasitePin >=0 ) digitalWrite(parasitePin, LOW); // deactivate power (close MOSFET)
+      currentSensor = 0;
+      oneWire->reset();
+      state = TS_READ_RESET;
+      return;
+    case TS_READ_RESET:
+      if (result == OW_DONE && oneWire->presence()) {
+        readScratchpad();
+        state = TS_READ;
+        return;
+      }
+      sensorTemp[currentSensor] = -127.0f;
+      break; // sensors disappeared
+    case TS_READ:
+      if (result == OW_DONE) {
+        const uint8_t *data = oneWire->data() + (sensorFound > 1 ? 10 : 2); // skip ROM & read commands
+        sensorTemp[currentSensor] = decodeDallas(data, sensorAddr[currentSensor][0]);
+      } else {
+        sensorTemp[currentSensor] = -127.0f;
+      }
+      if (++currentSensor < sensorFound) {
+        oneWire->reset();
+        state = TS_READ_RESET;
+        return;
+      }
+      break;
+  }
 
-  // check to see if we are due for taking a measurement
-  // lastMeasurement will not be updated until the conversion
-  // is complete the the reading is finished
-  if (now - lastMeasurement < readingInterval) return;
-
-  // we are due for a measurement, if we are not already waiting
-  // for a conversion to complete, then make a new request for temps
-  if (!waitingForConversion) {
-    requestTemperatures();
+  // measurement finished (or failed)
+  if (state == TS_CONVERT_RESET) sensorTemp[0] = -127.0f;
+  state = TS_IDLE;
+  readTemperature();
+  if (getTemperatureC() < -100.0f) {
+    if (++errorCount > 10) sensorFound = 0;
+    lastMeasurement = now - readingInterval + 300; // force new measurement in 300ms
     return;
   }
-
-  // we were waiting for a conversion to complete, have we waited log enough?
-  if (now - lastTemperaturesRequest >= 750 /* 93.75ms per the datasheet but can be up to 750ms */) {
-    readTemperature();
-    if (getTemperatureC() < -100.0f) {
-      if (++errorCount > 10) sensorFound = 0;
-      lastMeasurement = now - readingInterval + 300; // force new measurement in 300ms
-      return;
-    }
-    errorCount = 0;
+  errorCount = 0;
 
 #ifndef WLED_DISABLE_MQTT
-    if (WLED_MQTT_CONNECTED) {
-      char subuf[128];
-      strcpy(subuf, mqttDeviceTopic);
-      if (temperature > -100.0f) {
-        // dont publish super low temperature as the graph will get messed up
-        // the DallasTemperature library returns -127C or -196.6F when problem
-        // reading the sensor
-        strcat_P(subuf, _Temperature);
-        mqtt->publish(subuf, 0, false, String(getTemperatureC()).c_str());
-        strcat_P(subuf, PSTR("_f"));
-        mqtt->publish(subuf, 0, false, String(getTemperatureF()).c_str());
-        if (idx > 0) {
-          StaticJsonDocument <128> msg;
-          msg[F("idx")]    = idx;
-          msg[F("RSSI")]   = WiFi.RSSI();
-          msg[F("nvalue")] = 0;
-          msg[F("svalue")] = String(getTemperatureC());
-          serializeJson(msg, subuf, 127);
-          mqtt->publish("domoticz/in", 0, false, subuf);
-        }
-      } else {
-        // publish something else to indicate status?
-      }
-    }
+  publishTemperature();
 #endif
-  }
 }
 
 /**
@@ -347,6 +415,16 @@ void UsermodTemperature::addToJsonInfo(JsonObject& root) {
   temp.add(getTemperature());
   temp.add(getTemperatureUnit());
 
+  for (unsigned i = 1; i < sensorFound; i++) {
+    char name[24];
+    strcpy_P(name, _name);
+    sprintf_P(name + strlen(name), PSTR(" %u"), i+1);
+    temp = user.createNestedArray(name);
+    float t = degC ? sensorTemp[i] : sensorTemp[i] * 1.8f + 32.0f;
+    if (sensorTemp[i] <= -100.0f) temp.add(F("Sensor Error!"));
+    else { temp.add(t); temp.add(getTemperatureUnit()); }
+  }
+
   JsonObject sensor = root[FPSTR(_sensor)];
   if (sensor.isNull()) sensor = root.createNestedObject(FPSTR(_sensor));
   temp = sensor.createNestedArray(FPSTR(_temperature));
@@ -423,6 +501,7 @@ bool UsermodTemperature::readFromConfig(JsonObject &root) {
       DEBUG_PRINTLN(F("Re-init temperature."));
       // deallocate pin and release memory
       delete oneWire;
+      oneWire = nullptr;
       PinManager::deallocatePin(temperaturePin, PinOwner::UM_Temperature);
       temperaturePin = newTemperaturePin;
       PinManager::deallocatePin(parasitePin, PinOwner::UM_Temperature);
@@ -80,6 +80,24 @@ static bool udpSamplePeak = false;   // Boolean flag for peak. Set at the same t
 static unsigned long timeOfPeak = 0; // time of last sample peak detection.
 static uint8_t fftResult[NUM_GEQ_CHANNELS]= {0};// Our calculated freq. channel result table to be used by effects
 
+#ifdef ARDUINO_ARCH_ESP32
+// FFTcode() runs on another core. It publishes its results once per FFT cycle into the back buffer of fftSnapshot[],
+// loop() then latches the front buffer into fftResult/FFT_MajorPeak/FFT_Magnitude/samplePeak (same task as effects),
+// so effects never see a half-updated set of values within a frame.
+typedef struct FFTSnapshot {
+  uint8_t fftResult[NUM_GEQ_CHANNELS];
+  float   FFT_MajorPeak;
+  float   FFT_Magnitude;
+} fft_snapshot_t;
+static fft_snapshot_t fftSnapshot[2];           // front buffer is fftSnapshot[fftSnapshotSeq & 1]
+static volatile uint32_t fftSnapshotSeq = 0;    // incremented by FFTcode() after each publish
+static uint32_t fftLatchedSeq = 0;              // last sequence latched by loop()
+// peaks are counted separately so that a peak is not lost if loop() skips snapshots
+static volatile uint32_t fftPeakCount = 0;      // incremented by FFTcode() on each detected peak
+static volatile unsigned long fftPeakTime = 0;  // millis() of last detected peak
+static uint32_t fftLatchedPeaks = 0;            // last peak count consumed by loop()
+#endif
+
 // TODO: probably best not used by receive nodes
 //static float agcSensitivity = 128;            // AGC sensitivity estimation, based on agc gain (multAgc). calculated by getSensitivity(). range 0..255
 
@@ -99,6 +117,8 @@ static void detectSamplePeak(void);  // peak detection function (needs scaled FF
 static void autoResetPeak(void);     // peak auto-reset function
 static uint8_t maxVol = 31;          // (was 10) Reasonable value for constant volume for 'peak detector', as it won't always trigger  (deprecated)
 static uint8_t binNum = 8;           // Used to select the bin for FFT based beat detection  (deprecated)
+static uint8_t fxMaxVol = 31;        // maxVol as requested by effects (via um_data), forwarded to maxVol once per loop()
+static uint8_t fxBinNum = 8;         // binNum as requested by effects (via um_data), forwarded to binNum once per loop()
 
 #ifdef ARDUINO_ARCH_ESP32
 
@@ -152,7 +172,7 @@ static bool useBandPassFilter = false;                    // if true, enables a
 static float fftAddAvg(int from, int to);   // average of several FFT result bins
 void FFTcode(void * parameter);      // audio processing task: read samples, run FFT, fill GEQ channels from FFT results
 static void runMicFilter(uint16_t numSamples, float *sampleBuffer);          // pre-filtering of raw samples (band-pass)
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels); // post-processing and post-amp of GEQ channels
+static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels, uint8_t *result); // post-processing and post-amp of GEQ channels
 
 static TaskHandle_t FFT_Task = nullptr;
 
@@ -266,6 +286,8 @@ void FFTcode(void * parameter)
 
     xLastWakeTime = xTaskGetTickCount();       // update "last unblocked time" for vTaskDelay
 
+    fft_snapshot_t &fftBack = fftSnapshot[(fftSnapshotSeq + 1) & 1]; // only FFTcode() writes the back buffer
+
     // band pass filter - can reduce noise floor by a factor of 50
     // downside: frequencies below 100Hz will be ignored
     if (useBandPassFilter) runMicFilter(samplesFFT, vReal);
@@ -295,8 +317,8 @@ void FFTcode(void * parameter)
       FFT.complexToMagnitude();                                   // Compute magnitudes
       vReal[0] = 0;   // The remaining DC offset on the signal produces a strong spike on position 0 that should be eliminated to avoid issues.
 
-      FFT.majorPeak(&FFT_MajorPeak, &FFT_Magnitude);                // let the effects know which freq was most dominant
-      FFT_MajorPeak = constrain(FFT_MajorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
+      FFT.majorPeak(&fftBack.FFT_MajorPeak, &fftBack.FFT_Magnitude);              // let the effects know which freq was most dominant
+      fftBack.FFT_MajorPeak = constrain(fftBack.FFT_MajorPeak, 1.0f, 11025.0f);   // restrict value to range expected by effects
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
       haveDoneFFT = true;
@@ -304,8 +326,8 @@ void FFTcode(void * parameter)
 
     } else { // noise gate closed - only clear results as FFT was skipped. MIC samples are still valid when we do this.
       memset(vReal, 0, samplesFFT * sizeof(float));
-      FFT_MajorPeak = 1;
-      FFT_Magnitude = 0.001;
+      fftBack.FFT_MajorPeak = 1;
+      fftBack.FFT_Magnitude = 0.001;
     }
 
     for (int i = 0; i < samplesFFT; i++) {
@@ -380,7 +402,14 @@ void FFTcode(void * parameter)
     }
 
     // post-processing of frequency channels (pink noise adjustment, AGC, smoothing, scaling)
-    postProcessFFTResults((fabsf(sampleAvg) > 0.25f)? true : false , NUM_GEQ_CHANNELS);
+    postProcessFFTResults((fabsf(sampleAvg) > 0.25f)? true : false , NUM_GEQ_CHANNELS, fftBack.fftResult);
+
+    // run peak detection (peak is consumed by loop() with the next snapshot, auto-reset is done by loop())
+    detectSamplePeak();
+
+    // publish results: make sure all writes to the back buffer are visible before flipping buffers
+    __sync_synchronize();
+    fftSnapshotSeq = fftSnapshotSeq + 1;
 
 #if defined(WLED_DEBUG) || defined(SR_DEBUG)
     if (haveDoneFFT && (start < esp_timer_get_time())) { // filter out overflows
@@ -388,10 +417,7 @@ void FFTcode(void * parameter)
       fftTime  = (fftTimeInMillis*3 + fftTime*7)/10; // smooth
     }
 #endif
-    // run peak detection
-    autoResetPeak();
-    detectSamplePeak();
-    
+
     #if !defined(I2S_GRAB_ADC1_COMPLETELY)    
     if ((audioSource == nullptr) || (audioSource->getType() != AudioSource::Type_I2SAdc))  // the "delay trick" does not help for analog ADC
     #endif
@@ -436,7 +462,7 @@ static void runMicFilter(uint16_t numSamples, float *sampleBuffer)          // p
   }
 }
 
-static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // post-processing and post-amp of GEQ channels
+static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels, uint8_t *result) // post-processing and post-amp of GEQ channels
 {
     for (int i=0; i < numberOfChannels; i++) {
 
@@ -502,34 +528,61 @@ static void postProcessFFTResults(bool noiseGateOpen, int numberOfChannels) // p
         break;
       }
 
-      // Now, let's dump it all into fftResult. Need to do this, otherwise other routines might grab fftResult values prematurely.
+      // Now, let's dump it all into result (back buffer). Need to do this, otherwise other routines might grab fftResult values prematurely.
       if (soundAgc > 0) {  // apply extra "GEQ Gain" if set by user
         float post_gain = (float)inputLevel/128.0f;
         if (post_gain < 1.0f) post_gain = ((post_gain -1.0f) * 0.8f) +1.0f;
         currentResult *= post_gain;
       }
-      fftResult[i] = constrain((int)currentResult, 0, 255);
+      result[i] = constrain((int)currentResult, 0, 255);
     }
 }
+
+// called from loop() (same task as effects): copy the most recent complete FFT results for use in the next frame
+static void latchFFTSnapshot(void) {
+  uint32_t peaks = fftPeakCount;
+  if (peaks != fftLatchedPeaks) {    // at least one peak since last latch, even if its snapshot was already overwritten
+    __sync_synchronize();
+    fftLatchedPeaks = peaks;
+    samplePeak    = true;
+    timeOfPeak    = fftPeakTime;
+    udpSamplePeak = true;
+  }
+  for (int retry = 0; retry < 3; retry++) {
+    uint32_t seq = fftSnapshotSeq;
+    if (seq == fftLatchedSeq) return;  // nothing new (or FFT not running, i.e. UDP sound sync receive)
+    __sync_synchronize();
+    const fft_snapshot_t &front = fftSnapshot[seq & 1];
+    memcpy(fftResult, front.fftResult, sizeof(fftResult));
+    FFT_MajorPeak = front.FFT_MajorPeak;
+    FFT_Magnitude = front.FFT_Magnitude;
+    __sync_synchronize();
+    fftLatchedSeq = seq;
+    if (fftSnapshotSeq == seq) return; // FFTcode() did not start overwriting this buffer while we copied it
+  }
+}
 ////////////////////
 // Peak detection //
 ////////////////////
 
 // peak detection is called from FFT task when vReal[] contains valid FFT results
+// the peak is only counted, samplePeak/timeOfPeak are owned by loop() and set by latchFFTSnapshot()
 static void detectSamplePeak(void) {
+  static unsigned long lastPeak = 0; // timeOfPeak is updated only when the peak is latched
   bool havePeak = false;
   // softhack007: this code continuously triggers while amplitude in the selected bin is above a certain threshold. So it does not detect peaks - it detects high activity in a frequency bin.
   // Poor man's beat detection by seeing if sample > Average + some value.
   // This goes through ALL of the 255 bins - but ignores stupid settings
   // Then we got a peak, else we don't. The peak has to time out on its own in order to support UDP sound sync.
-  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - timeOfPeak) > 100)) {
+  if ((sampleAvg > 1) && (maxVol > 0) && (binNum > 4) && (vReal[binNum] > maxVol) && ((millis() - timeOfPeak) > 100) && ((millis() - lastPeak) > 100)) {
     havePeak = true;
   }
 
   if (havePeak) {
-    samplePeak    = true;
-    timeOfPeak    = millis();
-    udpSamplePeak = true;
+    lastPeak    = millis();
+    fftPeakTime = lastPeak;
+    __sync_synchronize();
+    fftPeakCount = fftPeakCount + 1;
   }
 }
 
@@ -1151,9 +1204,9 @@ class AudioReactive : public Usermod {
         um_data->u_type[4] = UMT_FLOAT;
         um_data->u_data[5] = &my_magnitude;   // used (New)
         um_data->u_type[5] = UMT_FLOAT;
-        um_data->u_data[6] = &maxVol;          // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
+        um_data->u_data[6] = &fxMaxVol;        // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
         um_data->u_type[6] = UMT_BYTE;
-        um_data->u_data[7] = &binNum;          // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
+        um_data->u_data[7] = &fxBinNum;        // assigned in effect function from UI element!!! (Puddlepeak, Ripplepeak, Waterfall)
         um_data->u_type[7] = UMT_BYTE;
       }
 
@@ -1360,6 +1413,11 @@ class AudioReactive : public Usermod {
         } while (userloopDelay > 0);
         lastUMRun = t_now;                    // update time keeping
 
+        // latch FFT results published by FFTcode() and forward effect parameters to it
+        latchFFTSnapshot();
+        maxVol = fxMaxVol;
+        binNum = fxBinNum;
+
         // update samples for effects (raw, smooth) 
         volumeSmth = (soundAgc) ? sampleAgc   : sampleAvg;
         volumeRaw  = (soundAgc) ? rawSampleAgc: sampleRaw;
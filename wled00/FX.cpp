@@ -5222,10 +5222,12 @@ uint16_t mode_2DHiphotic() {                        //  By: ldirko  https://edit
   const int cols = SEGMENT.virtualWidth();
   const int rows = SEGMENT.virtualHeight();
   const uint32_t a = strip.now / ((SEGMENT.custom3>>1)+1);
+  const uint32_t *lut = SEGMENT.getPaletteLUT(PALETTE_SOLID_WRAP); // nullptr on small segments
 
   for (int x = 0; x < cols; x++) {
     for (int y = 0; y < rows; y++) {
-      SEGMENT.setPixelColorXY(x, y, SEGMENT.color_from_palette(sin8(cos8(x * SEGMENT.speed/16 + a / 3) + sin8(y * SEGMENT.intensity/16 + a / 4) + a), false, PALETTE_SOLID_WRAP, 0));
+      uint8_t idx = sin8(cos8(x * SEGMENT.speed/16 + a / 3) + sin8(y * SEGMENT.intensity/16 + a / 4) + a);
+      SEGMENT.setPixelColorXY(x, y, lut ? lut[idx] : SEGMENT.color_from_palette(idx, false, PALETTE_SOLID_WRAP, 0));
     }
   }
 
@@ -6132,26 +6134,26 @@ uint16_t mode_2Dscrollingtext(void) {
   const bool zero = strchr(text, '0') != nullptr;
 
   char sec[5];
-  int  AmPmHour = hour(localTime);
+  int  AmPmHour = localHour();
   bool isitAM = true;
   if (useAMPM) {
     if (AmPmHour > 11) { AmPmHour -= 12; isitAM = false; }
     if (AmPmHour == 0) { AmPmHour  = 12; }
     sprintf_P(sec, PSTR(" %2s"), (isitAM ? "AM" : "PM"));
   } else {
-    sprintf_P(sec, PSTR(":%02d"), second(localTime));
+    sprintf_P(sec, PSTR(":%02d"), localSecond());
   }
 
   if (!strlen(text)) { // fallback if empty segment name: display date and time
-    sprintf_P(text, PSTR("%s %d, %d %d:%02d%s"), monthShortStr(month(localTime)), day(localTime), year(localTime), AmPmHour, minute(localTime), sec);
+    sprintf_P(text, PSTR("%s %d, %d %d:%02d%s"), monthShortStr(localMonth()), localDay(), localYear(), AmPmHour, localMinute(), sec);
   } else {
-    if      (!strncmp_P(text,PSTR("#DATE"),5)) sprintf_P(text, zero?PSTR("%02d.%02d.%04d"):PSTR("%d.%d.%d"),   day(localTime),   month(localTime),  year(localTime));
-    else if (!strncmp_P(text,PSTR("#DDMM"),5)) sprintf_P(text, zero?PSTR("%02d.%02d")     :PSTR("%d.%d"),      day(localTime),   month(localTime));
-    else if (!strncmp_P(text,PSTR("#MMDD"),5)) sprintf_P(text, zero?PSTR("%02d/%02d")     :PSTR("%d/%d"),      month(localTime), day(localTime));
-    else if (!strncmp_P(text,PSTR("#TIME"),5)) sprintf_P(text, zero?PSTR("%02d:%02d%s")   :PSTR("%2d:%02d%s"), AmPmHour,         minute(localTime), sec);
-    else if (!strncmp_P(text,PSTR("#HHMM"),5)) sprintf_P(text, zero?PSTR("%02d:%02d")     :PSTR("%d:%02d"),    AmPmHour,         minute(localTime));
+    if      (!strncmp_P(text,PSTR("#DATE"),5)) sprintf_P(text, zero?PSTR("%02d.%02d.%04d"):PSTR("%d.%d.%d"),   localDay(),   localMonth(),  localYear());
+    else if (!strncmp_P(text,PSTR("#DDMM"),5)) sprintf_P(text, zero?PSTR("%02d.%02d")     :PSTR("%d.%d"),      localDay(),   localMonth());
+    else if (!strncmp_P(text,PSTR("#MMDD"),5)) sprintf_P(text, zero?PSTR("%02d/%02d")     :PSTR("%d/%d"),      localMonth(), localDay());
+    else if (!strncmp_P(text,PSTR("#TIME"),5)) sprintf_P(text, zero?PSTR("%02d:%02d%s")   :PSTR("%2d:%02d%s"), AmPmHour,         localMinute(), sec);
+    else if (!strncmp_P(text,PSTR("#HHMM"),5)) sprintf_P(text, zero?PSTR("%02d:%02d")     :PSTR("%d:%02d"),    AmPmHour,         localMinute());
     else if (!strncmp_P(text,PSTR("#HH"),3))   sprintf_P(text, zero?PSTR("%02d")          :PSTR("%d"),         AmPmHour);
-    else if (!strncmp_P(text,PSTR("#MM"),3))   sprintf_P(text, zero?PSTR("%02d")          :PSTR("%d"),         minute(localTime));
+    else if (!strncmp_P(text,PSTR("#MM"),3))   sprintf_P(text, zero?PSTR("%02d")          :PSTR("%d"),         localMinute());
   }
 
   const int  numberOfLetters = strlen(text);
@@ -6256,13 +6258,15 @@ uint16_t mode_2Dplasmarotozoom() {
   float f       = (sin_t(*a/2)+((128-SEGMENT.intensity)/128.0f)+1.1f)/1.5f;  // scale factor
   float kosinus = cos_t(*a) * f;
   float sinus   = sin_t(*a) * f;
+  const uint32_t *lut = SEGMENT.getPaletteLUT(PALETTE_SOLID_WRAP, 255); // nullptr on small segments
   for (int i = 0; i < cols; i++) {
     float u1 = i * kosinus;
     float v1 = i * sinus;
     for (int j = 0; j < rows; j++) {
         byte u = abs8(u1 - j * sinus) % cols;
         byte v = abs8(v1 + j * kosinus) % rows;
-        SEGMENT.setPixelColorXY(i, j, SEGMENT.color_from_palette(plasma[v*cols+u], false, PALETTE_SOLID_WRAP, 255));
+        byte p = plasma[v*cols+u];
+        SEGMENT.setPixelColorXY(i, j, lut ? lut[p] : SEGMENT.color_from_palette(p, false, PALETTE_SOLID_WRAP, 255));
     }
   }
   *a -= 0.03f + float(SEGENV.speed-128)*0.0002f;  // rotation speed
@@ -57,28 +57,74 @@
 #define FPS_CALC_SHIFT 7 // bit shift for fixed point math
 
 /* each segment uses 82 bytes of SRAM memory, so if you're application fails because of
-  insufficient memory, decreasing MAX_NUM_SEGMENTS may help */
+  insufficient memory, decreasing MAX_NUM_SEGMENTS may help
+  segment IDs are 8 bit, installations with one segment per fixture may use up to 255
+  (state JSON streams segments, presets hold only as many segments as fit into JSON_BUFFER_SIZE) */
 #ifdef ESP8266
-  #define MAX_NUM_SEGMENTS    16
+  #ifndef MAX_NUM_SEGMENTS
+    #define MAX_NUM_SEGMENTS  16
+  #endif
   /* How much data bytes all segments combined may allocate */
   #define MAX_SEGMENT_DATA  5120
 #else
   #ifndef MAX_NUM_SEGMENTS
     #define MAX_NUM_SEGMENTS  32
   #endif
+  /* effect data budget does not grow beyond 32 segments (internal RAM), large counts share it */
+  #define DATA_SEGMENTS (MAX_NUM_SEGMENTS < 32 ? MAX_NUM_SEGMENTS : 32)
   #if defined(ARDUINO_ARCH_ESP32S2)
-    #define MAX_SEGMENT_DATA  MAX_NUM_SEGMENTS*768 // 24k by default (S2 is short on free RAM)
+    #define MAX_SEGMENT_DATA  DATA_SEGMENTS*768 // 24k by default (S2 is short on free RAM)
   #else
-    #define MAX_SEGMENT_DATA  MAX_NUM_SEGMENTS*1280 // 40k by default
+    #define MAX_SEGMENT_DATA  DATA_SEGMENTS*1280 // 40k by default
   #endif
 #endif
+#if MAX_NUM_SEGMENTS > 255
+  #error "MAX_NUM_SEGMENTS must not exceed 255 (8 bit segment IDs)."
+#endif
+
+// realtime data of segments bound to a network source is written by the network task (AsyncUDP on ESP32)
+#ifdef ARDUINO_ARCH_ESP32
+  #define SEG_RT_LOCK()   portENTER_CRITICAL(&Segment::rtMux)
+  #define SEG_RT_UNLOCK() portEXIT_CRITICAL(&Segment::rtMux)
+#else
+  #define SEG_RT_LOCK()
+  #define SEG_RT_UNLOCK()
+#endif
+
+// realtime source binding of an active segment, the table is rebuilt by service() (loop task) when bindings change
+// network task only reads it and writes pixels, sequence numbers and timeout while holding SEG_RT_LOCK
+typedef struct RealtimeBinding {
+  uint32_t      *data;    // received pixels (virtual segment length)
+  uint8_t       *seq;     // last E1.31/Art-Net sequence number of each universe spanned by segment (nullptr for others)
+  unsigned long  until;   // millis() until which received data is shown instead of the effect
+  uint32_t       first;   // first source pixel (E1.31/Art-Net pixels are counted from universe 0)
+  uint16_t       len;
+  uint16_t       timeout; // rtTimeout of segment
+  uint8_t        proto;
+  uint8_t        segment; // index of bound segment
+  bool           fresh;   // data received since it was drawn
+} rt_binding_t;
 
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / strip.getMaxSegments())
 
+/* Largest 2D segment (in physical pixels) for which a coordinate->LED lookup table is kept (2 bytes per pixel) */
+#ifndef MAX_SEGMENT_PIXELMAP
+  #ifdef ESP8266
+    #define MAX_SEGMENT_PIXELMAP 1024
+  #else
+    #define MAX_SEGMENT_PIXELMAP 4096
+  #endif
+#endif
+
 #define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
 
+/* Frame budget scheduling: a segment that would not fit into remaining frame budget may be postponed
+  at most (SEG_MAX_DEFER >> priority) consecutive frames; priority 3 segments are never postponed */
+#define SEG_MAX_DEFER    8
+#define SEG_PRIORITY_MAX 3
+
 #define NUM_COLORS       3 /* number of colors per segment */
 #define SEGMENT          strip._segments[strip.getCurrSegmentId()]
 #define SEGENV           strip._segments[strip.getCurrSegmentId()]
@@ -363,6 +409,11 @@ typedef struct Segment {
     };
     uint8_t startY;  // start Y coodrinate 2D (top); there should be no more than 255 rows
     uint8_t stopY;   // stop Y coordinate 2D (bottom); there should be no more than 255 rows
+    uint8_t fps;      // target frame rate of segment (0 = strip target FPS)
+    uint8_t priority; // 0-3 scheduling priority, low priority segments are postponed first if frame budget is exceeded
+    uint8_t  rtProto;   // realtime protocol bound to segment (REALTIME_MODE_UDP/E131/ARTNET/DDP, 0 = none)
+    uint16_t rtStart;   // first universe (E1.31/Art-Net) or first pixel (DDP/UDP) of the bound realtime data
+    uint16_t rtTimeout; // ms without realtime data after which the effect resumes (0 = realtime timeout setting)
     char    *name;
 
     // runtime data
@@ -372,7 +423,15 @@ typedef struct Segment {
     uint16_t aux0;  // custom var
     uint16_t aux1;  // custom var
     byte     *data; // effect data pointer
+    uint16_t renderTime; // averaged effect render time in us (used for frame budget)
+    uint8_t  deferred;   // number of consecutive frames segment was postponed
+    unsigned long rtUntil; // millis() until which bound realtime data is shown instead of the effect
     static uint16_t maxWidth, maxHeight;  // these define matrix width & height (max. segment dimensions)
+    static bool     resetPending;         // a segment was marked for reset since last service()
+    static volatile bool rtPending;       // realtime data arrived for a segment since last service()
+    #ifdef ARDUINO_ARCH_ESP32
+    static portMUX_TYPE  rtMux;           // guards realtime bindings table while network task uses it
+    #endif
 
     typedef struct TemporarySegmentData {
       uint16_t _optionsT;
@@ -411,6 +470,9 @@ typedef struct Segment {
     };
     uint16_t        _dataLen;
     static uint16_t _usedSegmentData;
+    uint16_t       *_pixelMap;            // 2D: physical LED index of each pixel of segment rectangle (built on demand)
+    uint32_t        _pixelMapGen;         // generation _pixelMap was built for (0 = none)
+    static uint32_t _pixelMapGeneration;  // incremented when matrix/ledmap changes (invalidates all _pixelMap, 32 bit: never wraps)
 
     // perhaps this should be per segment, not static
     static CRGBPalette16 _currentPalette;     // palette used for current effect (includes transition, used in color_from_palette())
@@ -418,6 +480,8 @@ typedef struct Segment {
     static CRGBPalette16 _newRandomPalette;   // target random palette
     static uint16_t _lastPaletteChange;       // last random palette change time in millis()/1000
     static uint16_t _lastPaletteBlend;        // blend palette according to set Transition Delay in millis()%0xFFFF
+    static uint32_t *_paletteLUT;             // 256 colors of current palette for indexed rendering (allocated on first use)
+    static unsigned long _paletteLUTUsed;     // millis() of last getPaletteLUT() call, unused table is freed
     #ifndef WLED_DISABLE_MODE_BLEND
     static bool          _modeBlend;          // mode/effect blending semaphore
     #endif
@@ -468,6 +532,11 @@ typedef struct Segment {
       check3(false),
       startY(0),
       stopY(1),
+      fps(0),
+      priority(2),
+      rtProto(REALTIME_MODE_INACTIVE),
+      rtStart(0),
+      rtTimeout(0),
       name(nullptr),
       next_time(0),
       step(0),
@@ -475,13 +544,19 @@ typedef struct Segment {
       aux0(0),
       aux1(0),
       data(nullptr),
+      renderTime(0),
+      deferred(0),
+      rtUntil(0),
       _capabilities(0),
       _dataLen(0),
+      _pixelMap(nullptr),
+      _pixelMapGen(0),
       _t(nullptr)
     {
       #ifdef WLED_DEBUG
       //Serial.printf("-- Creating segment: %p\n", this);
       #endif
+      resetPending = true; // new segment has to be rendered
     }
 
     Segment(uint16_t sStartX, uint16_t sStopX, uint16_t sStartY, uint16_t sStopY) : Segment(sStartX, sStopX) {
@@ -502,10 +577,12 @@ typedef struct Segment {
       if (name) { delete[] name; name = nullptr; }
       stopTransition();
       deallocateData();
+      freePixelMap();
     }
 
     Segment& operator= (const Segment &orig); // copy assignment
     Segment& operator= (Segment &&orig) noexcept; // move assignment
+    Segment  cloneSettings() const; // copy without effect runtime data (e.g. for state slots)
 
 #ifdef WLED_DEBUG
     size_t getSize() const { return sizeof(Segment) + (data?_dataLen:0) + (name?strlen(name):0) + (_t?sizeof(Transition):0); }
@@ -515,6 +592,7 @@ typedef struct Segment {
     inline bool     isSelected()         const { return selected; }
     inline bool     isInTransition()     const { return _t != nullptr; }
     inline bool     isActive()           const { return stop > start; }
+    inline bool     isLive(unsigned long t) const { return rtProto && long(rtUntil - t) > 0; } // showing bound realtime data
     inline bool     is2D()               const { return (width()>1 && height()>1); }
     inline bool     hasRGB()             const { return _isRGB; }
     inline bool     hasWhite()           const { return _hasW; }
@@ -531,7 +609,9 @@ typedef struct Segment {
     inline static void modeBlend(bool blend)       { _modeBlend = blend; }
     #endif
     static void     handleRandomPalette();
+    static void     releasePaletteLUT(unsigned long now); // frees palette LUT if no effect requested it for a second
     inline static const CRGBPalette16 &getCurrentPalette() { return Segment::_currentPalette; }
+    inline static void invalidatePixelMaps()       { if (++_pixelMapGeneration == 0) _pixelMapGeneration = 1; } // matrix or ledmap changed
 
     void    setUp(uint16_t i1, uint16_t i2, uint8_t grp=1, uint8_t spc=0, uint16_t ofs=UINT16_MAX, uint16_t i1Y=0, uint16_t i2Y=1);
     Segment &setColor(uint8_t slot, uint32_t c);
@@ -548,18 +628,20 @@ typedef struct Segment {
     bool allocateData(size_t len);  // allocates effect data buffer in heap and clears it
     void deallocateData();          // deallocates (frees) effect data buffer from heap
     void resetIfRequired();         // sets all SEGENV variables to 0 and clears data buffer
+    inline void freePixelMap()      { freeMem(_pixelMap); _pixelMap = nullptr; _pixelMapGen = 0; }
     /**
       * Flags that before the next effect is calculated,
       * the internal segment state should be reset.
       * Call resetIfRequired before calling the next effect function.
       * Safe to call from interrupts and network requests.
       */
-    inline Segment &markForReset() { reset = true; return *this; }  // setOption(SEG_OPTION_RESET, true)
+    inline Segment &markForReset() { reset = true; resetPending = true; return *this; }  // setOption(SEG_OPTION_RESET, true)
 
     // transition functions
     void     startTransition(uint16_t dur);     // transition has to start before actual segment values change
     void     stopTransition();                  // ends transition mode by destroying transition structure (does nothing if not in transition)
     inline void handleTransition() { if (progress() == 0xFFFFU) stopTransition(); }
+    void     restore(const Segment &orig, uint16_t dur); // replaces segment with a copy of orig, cross-fading from current look
     #ifndef WLED_DISABLE_MODE_BLEND
     void     swapSegenv(tmpsegd_t &tmpSegD);    // copies segment data into specifed buffer, if buffer is not a transition buffer, segment data is overwritten from transition buffer
     void     restoreSegenv(tmpsegd_t &tmpSegD); // restores segment data from buffer, if buffer is not transition buffer, changed values are copied to transition buffer
@@ -595,6 +677,7 @@ typedef struct Segment {
     inline void addPixelColor(int n, CRGB c, bool fast = false)          { addPixelColor(n, RGBW32(c.r,c.g,c.b,0), fast); }
     inline void fadePixelColor(uint16_t n, uint8_t fade)                 { setPixelColor(n, color_fade(getPixelColor(n), fade, true)); }
     [[gnu::hot]] uint32_t color_from_palette(uint16_t, bool mapping, bool wrap, uint8_t mcol, uint8_t pbri = 255) const;
+    const uint32_t *getPaletteLUT(bool wrap, uint8_t mcol = 0) const; // palette expanded to 256 colors for large segments (or nullptr)
     [[gnu::hot]] uint32_t color_wheel(uint8_t pos) const;
 
     // 2D Blur: shortcuts for bluring columns or rows only (50% faster than full 2D blur)
@@ -619,6 +702,7 @@ typedef struct Segment {
     }
   #ifndef WLED_DISABLE_2D
     [[gnu::hot]] uint16_t XY(int x, int y);      // support function to get relative index within segment
+    void updatePixelMap();                       // (re)builds segment's coordinate->LED lookup table
     [[gnu::hot]] void setPixelColorXY(int x, int y, uint32_t c); // set relative pixel within segment with color
     inline void setPixelColorXY(unsigned x, unsigned y, uint32_t c)               { setPixelColorXY(int(x), int(y), c); }
     inline void setPixelColorXY(int x, int y, byte r, byte g, byte b, byte w = 0) { setPixelColorXY(x, y, RGBW32(r,g,b,w)); }
@@ -641,8 +725,9 @@ typedef struct Segment {
     void blur2D(uint8_t blur_amount, bool smear = false);
     void blurRow(uint32_t row, fract8 blur_amount, bool smear = false);
     void blurCol(uint32_t col, fract8 blur_amount, bool smear = false);
-    void moveX(int8_t delta, bool wrap = false);
-    void moveY(int8_t delta, bool wrap = false);
+    void moveXY(int dx, int dy, bool wrap = false);
+    inline void moveX(int8_t delta, bool wrap = false) { moveXY(delta, 0, wrap); }
+    inline void moveY(int8_t delta, bool wrap = false) { moveXY(0, delta, wrap); }
     void move(uint8_t dir, uint8_t delta, bool wrap = false);
     void drawCircle(uint16_t cx, uint16_t cy, uint8_t radius, uint32_t c, bool soft = false);
     inline void drawCircle(uint16_t cx, uint16_t cy, uint8_t radius, CRGB c, bool soft = false) { drawCircle(cx, cy, radius, RGBW32(c.r,c.g,c.b,0), soft); }
@@ -654,6 +739,13 @@ typedef struct Segment {
     inline void drawCharacter(unsigned char chr, int16_t x, int16_t y, uint8_t w, uint8_t h, CRGB c) { drawCharacter(chr, x, y, w, h, RGBW32(c.r,c.g,c.b,0)); } // automatic inline
     inline void drawCharacter(unsigned char chr, int16_t x, int16_t y, uint8_t w, uint8_t h, CRGB c, CRGB c2, int8_t rotate = 0) { drawCharacter(chr, x, y, w, h, RGBW32(c.r,c.g,c.b,0), RGBW32(c2.r,c2.g,c2.b,0), rotate); } // automatic inline
     void wu_pixel(uint32_t x, uint32_t y, CRGB c);
+    // anti-aliased vector primitives, coordinates/widths/radii are 24.8 fixed point
+    void coverPixelXY(int x, int y, uint32_t c, unsigned cov);
+    void fillPolygon(const int32_t *pts, unsigned n, uint32_t c);
+    void drawThickLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t width, uint32_t c);
+    void drawPolyline(const int32_t *pts, unsigned n, uint32_t width, uint32_t c);
+    void drawArc(int32_t cx, int32_t cy, uint32_t r0, uint32_t r1, uint16_t a0, uint16_t a1, uint32_t c);
+    void fillGradient(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t c0, uint32_t c1, bool radial = false);
     inline void blur2d(fract8 blur_amount) { blur(blur_amount); }
     inline void fill_solid(CRGB c) { fill(RGBW32(c.r,c.g,c.b,0)); }
   #else
@@ -679,6 +771,7 @@ typedef struct Segment {
     inline void blur2D(uint8_t blur_amount, bool smear = false) {}
     inline void blurRow(uint32_t row, fract8 blur_amount, bool smear = false) {}
     inline void blurCol(uint32_t col, fract8 blur_amount, bool smear = false) {}
+    inline void moveXY(int dx, int dy, bool wrap = false) {}
     inline void moveX(int8_t delta, bool wrap = false) {}
     inline void moveY(int8_t delta, bool wrap = false) {}
     inline void move(uint8_t dir, uint8_t delta, bool wrap = false) {}
@@ -692,6 +785,12 @@ typedef struct Segment {
     inline void drawCharacter(unsigned char chr, int16_t x, int16_t y, uint8_t w, uint8_t h, CRGB color) {}
     inline void drawCharacter(unsigned char chr, int16_t x, int16_t y, uint8_t w, uint8_t h, CRGB c, CRGB c2, int8_t rotate = 0) {}
     inline void wu_pixel(uint32_t x, uint32_t y, CRGB c) {}
+    inline void coverPixelXY(int x, int y, uint32_t c, unsigned cov) {}
+    inline void fillPolygon(const int32_t *pts, unsigned n, uint32_t c) {}
+    inline void drawThickLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t width, uint32_t c) {}
+    inline void drawPolyline(const int32_t *pts, unsigned n, uint32_t width, uint32_t c) {}
+    inline void drawArc(int32_t cx, int32_t cy, uint32_t r0, uint32_t r1, uint16_t a0, uint16_t a1, uint32_t c) {}
+    inline void fillGradient(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t c0, uint32_t c1, bool radial = false) {}
   #endif
 } segment;
 //static int segSize = sizeof(Segment);
@@ -731,6 +830,8 @@ class WS2812FX {  // 96 bytes
       // semi-private (just obscured) used in effect functions through macros
       _colors_t{0,0,0},
       _virtualSegmentLength(0),
+      _rtBindings(nullptr),
+      _rtBindingCount(0),
       // true private variables
       _suspend(false),
       _length(DEFAULT_LED_COUNT),
@@ -738,7 +839,16 @@ class WS2812FX {  // 96 bytes
       _transitionDur(750),
       _targetFps(WLED_FPS),
       _frametime(FRAMETIME_FIXED),
+      _frameBudget(0),
       _cumulativeFps(50 << FPS_CALC_SHIFT),
+      _fadeStart(0),
+      _fadeDuration(0),
+      _fadeColFrom(0),
+      _fadeColTo(0),
+      _fadeBriFrom(0),
+      _fadeBriTo(0),
+      _fadeColor(false),
+      _fadeFrame(0),
       _isServicing(false),
       _isOffRefreshRequired(false),
       _hasWhiteChannel(false),
@@ -748,6 +858,7 @@ class WS2812FX {  // 96 bytes
       customMappingTable(nullptr),
       customMappingSize(0),
       _lastShow(0),
+      _nextDue(0),
       _segment_index(0),
       _mainSegment(0)
     {
@@ -759,7 +870,8 @@ class WS2812FX {  // 96 bytes
     }
 
     ~WS2812FX() {
-      if (customMappingTable) delete[] customMappingTable;
+      freeMem(customMappingTable);
+      freeMem(_rtBindings);
       _mode.clear();
       _modeData.clear();
       _segments.clear();
@@ -791,6 +903,8 @@ class WS2812FX {  // 96 bytes
       setPixelColor(unsigned n, uint32_t c),      // paints absolute strip pixel with index n and color c
       show(),                                     // initiates LED output
       setTargetFps(uint8_t fps),
+      setFrameBudget(uint16_t ms),
+      startFade(uint8_t briFrom, uint8_t briTo, uint32_t duration, uint32_t colFrom = 0, uint32_t colTo = 0, bool fadeColor = false), // long fade applied every frame (nightlight)
       setupEffectData();                          // add default effects to the list; defined in FX.cpp
 
     inline void resetTimebase()           { timebase = 0UL - millis(); }
@@ -806,6 +920,7 @@ class WS2812FX {  // 96 bytes
     inline void appendSegment(const Segment &seg = Segment()) { if (_segments.size() < getMaxSegments()) _segments.push_back(seg); }
     inline void suspend()                                     { _suspend = true; }    // will suspend (and canacel) strip.service() execution
     inline void resume()                                      { _suspend = false; }   // will resume strip.service() execution
+    inline void stopFade()                                    { _fadeDuration = 0; }  // stops long fade, leaving brightness and colors where they are
 
     bool
       paletteFade,
@@ -820,6 +935,7 @@ class WS2812FX {  // 96 bytes
     inline bool isOffRefreshRequired() const { return _isOffRefreshRequired; }  // returns true if strip requires regular updates (i.e. TM1814 chipset)
     inline bool isSuspended() const          { return _suspend; }               // returns true if strip.service() execution is suspended
     inline bool needsUpdate() const          { return _triggered; }             // returns true if strip received a trigger() request
+    inline bool isFading() const             { return _fadeDuration; }          // returns true if long fade is in progress
 
     uint8_t
       paletteBlend,
@@ -846,6 +962,7 @@ class WS2812FX {  // 96 bytes
       getMappedPixelIndex(uint16_t index) const;
 
     inline uint16_t getFrameTime() const    { return _frametime; }        // returns amount of time a frame should take (in ms)
+    inline uint16_t getFrameBudget() const  { return _frameBudget; }      // returns configured time (in ms) for rendering all segments (0 = frame time)
     inline uint16_t getMinShowDelay() const { return MIN_SHOW_DELAY; }    // returns minimum amount of time strip.service() can be delayed (constant)
     inline uint16_t getLength() const       { return _length; }           // returns actual amount of LEDs on a strip (2D matrix may have less LEDs than W*H)
     inline uint16_t getTransition() const   { return _transitionDur; }    // returns currently set transition time (in ms)
@@ -912,7 +1029,7 @@ class WS2812FX {  // 96 bytes
 
   // end 2D support
 
-    void loadCustomPalettes(); // loads custom palettes from JSON
+    void loadCustomPalettes(bool recompile = false); // loads custom palettes from binary store (recompiles changed JSON files, or all)
     std::vector<CRGBPalette16> customPalettes; // TODO: move custom palettes out of WS2812FX class
 
     struct {
@@ -929,6 +1046,9 @@ class WS2812FX {  // 96 bytes
     std::vector<segment> _segments;
     friend class Segment;
 
+    rt_binding_t *_rtBindings;     // see setSegmentRealtimePixels()
+    uint8_t       _rtBindingCount;
+
   private:
     volatile bool _suspend;
 
@@ -938,8 +1058,22 @@ class WS2812FX {  // 96 bytes
 
     uint8_t  _targetFps;
     uint16_t _frametime;
+    uint16_t _frameBudget;
     uint16_t _cumulativeFps;
 
+    // long fade (nightlight), interpolated with 8.8 fixed point and temporally dithered to 8 bit on every frame
+    unsigned long _fadeStart;
+    uint32_t _fadeDuration;
+    uint32_t _fadeColFrom;
+    uint32_t _fadeColTo;
+    uint8_t  _fadeBriFrom;
+    uint8_t  _fadeBriTo;
+    bool     _fadeColor;
+    uint8_t  _fadeFrame;
+
+    bool applyFade(unsigned long nowUp);
+    void updateRealtimeBindings();
+
     // will require only 1 byte
     struct {
       bool _isServicing          : 1;
@@ -958,6 +1092,7 @@ class WS2812FX {  // 96 bytes
     uint16_t  customMappingSize;
 
     unsigned long _lastShow;
+    unsigned long _nextDue; // millis() when the earliest active segment needs rendering (service() skips segments before)
 
     uint8_t _segment_index;
     uint8_t _mainSegment;
@@ -49,9 +49,10 @@ void WS2812FX::setUpMatrix() {
     }
 
     customMappingSize = 0; // prevent use of mapping if anything goes wrong
+    Segment::invalidatePixelMaps();
 
-    if (customMappingTable) delete[] customMappingTable;
-    customMappingTable = new uint16_t[getLengthTotal()];
+    freeMem(customMappingTable);
+    customMappingTable = static_cast<uint16_t*>(allocMem(getLengthTotal() * sizeof(uint16_t), MEM_MAP, MEM_OWNER_LEDMAP));
 
     if (customMappingTable) {
       customMappingSize = getLengthTotal();
@@ -153,6 +154,26 @@ uint16_t IRAM_ATTR_YN Segment::XY(int x, int y)
   return isActive() ? (x%width) + (y%height) * width : 0;
 }
 
+// resolves matrix position (panels, serpentine, ledmap) of each physical pixel within segment once
+// so that setPixelColorXY() can write directly to bus; rebuilt when matrix or ledmap changes
+void Segment::updatePixelMap()
+{
+  freePixelMap();
+  _pixelMapGen = _pixelMapGeneration; // do not retry until something changes (even if we fail)
+  const unsigned W = width();
+  const unsigned H = height();
+  if (!strip.isMatrix || !isActive() || W*H > MAX_SEGMENT_PIXELMAP) return;
+  if (stop > Segment::maxWidth || stopY > Segment::maxHeight) return; // segment is not within matrix
+  _pixelMap = (uint16_t*)allocMem(W * H * sizeof(uint16_t), MEM_MAP, MEM_OWNER_PIXELMAP);
+  if (!_pixelMap) return; // will use slow path
+  for (unsigned y = 0; y < H; y++) for (unsigned x = 0; x < W; x++) {
+    unsigned i = (startY + y) * Segment::maxWidth + start + x;
+    if (i < strip.customMappingSize) i = strip.customMappingTable[i];
+    _pixelMap[y * W + x] = i < strip._length ? i : 0xFFFFU; // 0xFFFF: no LED at this position
+  }
+  DEBUG_PRINTF_P(PSTR("Segment %p pixel map: %ux%u\n"), this, W, H);
+}
+
 void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
 {
   if (!isActive()) return; // not active
@@ -174,6 +195,18 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
   int H = height();
   if (x >= W || y >= H) return;  // if pixel would fall out of segment just exit
 
+  // use pre-resolved LED indices if ledmap is in use (same condition as WS2812FX::getMappedPixelIndex())
+  const uint16_t *map = nullptr;
+  if (realtimeMode == REALTIME_MODE_INACTIVE || realtimeRespectLedMaps) {
+    if (_pixelMapGen != _pixelMapGeneration) updatePixelMap();
+    map = _pixelMap;
+  }
+  // set pixel at physical position within segment
+  auto setPixel = [&](int px, int py, uint32_t c) {
+    if (map) { unsigned i = map[py * W + px]; if (i < 0xFFFFU) BusManager::setPixelColor(i, c); }
+    else     strip.setPixelColorXY(start + px, startY + py, c);
+  };
+
   uint32_t tmpCol = col;
   for (int j = 0; j < grouping; j++) {   // groupping vertically
     for (int g = 0; g < grouping; g++) { // groupping horizontally
@@ -182,21 +215,24 @@ void IRAM_ATTR_YN Segment::setPixelColorXY(int x, int y, uint32_t col)
 
 #ifndef WLED_DISABLE_MODE_BLEND
       // if blending modes, blend with underlying pixel
-      if (_modeBlend) tmpCol = color_blend(strip.getPixelColorXY(start + xX, startY + yY), col, 0xFFFFU - progress(), true);
+      if (_modeBlend) {
+        uint32_t old = map ? (map[yY * W + xX] < 0xFFFFU ? BusManager::getPixelColor(map[yY * W + xX]) : 0) : strip.getPixelColorXY(start + xX, startY + yY);
+        tmpCol = color_blend(old, col, 0xFFFFU - progress(), true);
+      }
 #endif
 
-      strip.setPixelColorXY(start + xX, startY + yY, tmpCol);
+      setPixel(xX, yY, tmpCol);
 
       if (mirror) { //set the corresponding horizontally mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + xX, startY + height() - yY - 1, tmpCol);
-        else           strip.setPixelColorXY(start + width() - xX - 1, startY + yY, tmpCol);
+        if (transpose) setPixel(xX, H - yY - 1, tmpCol);
+        else           setPixel(W - xX - 1, yY, tmpCol);
       }
       if (mirror_y) { //set the corresponding vertically mirrored pixel
-        if (transpose) strip.setPixelColorXY(start + width() - xX - 1, startY + yY, tmpCol);
-        else           strip.setPixelColorXY(start + xX, startY + height() - yY - 1, tmpCol);
+        if (transpose) setPixel(W - xX - 1, yY, tmpCol);
+        else           setPixel(xX, H - yY - 1, tmpCol);
       }
       if (mirror_y && mirror) { //set the corresponding vertically AND horizontally mirrored pixel
-        strip.setPixelColorXY(start + width() - xX - 1, startY + height() - yY - 1, tmpCol);
+        setPixel(W - xX - 1, H - yY - 1, tmpCol);
       }
     }
   }
@@ -258,6 +294,10 @@ uint32_t IRAM_ATTR_YN Segment::getPixelColorXY(int x, int y) const {
   x *= groupLength(); // expand to physical pixels
   y *= groupLength(); // expand to physical pixels
   if (x >= width() || y >= height()) return 0;
+  if (_pixelMap && _pixelMapGen == _pixelMapGeneration && (realtimeMode == REALTIME_MODE_INACTIVE || realtimeRespectLedMaps)) {
+    unsigned i = _pixelMap[y * width() + x];
+    return i < 0xFFFFU ? BusManager::getPixelColor(i) : 0;
+  }
   return strip.getPixelColorXY(start + x, startY + y);
 }
 
@@ -449,40 +489,65 @@ void Segment::box_blur(unsigned radius, bool smear) {
   delete[] tmpWSum;
 }
 
-void Segment::moveX(int8_t delta, bool wrap) {
+// moveXY() - shift segment content so that pixel (x+dx, y+dy) ends up at (x, y)
+// single row-major pass; equivalent to moveX(dx) followed by moveY(dy)
+// without wrap the exposed rows/columns keep their previous content (and are not rewritten)
+void Segment::moveXY(int dx, int dy, bool wrap) {
   if (!isActive()) return; // not active
   const int cols = virtualWidth();
   const int rows = virtualHeight();
-  if (!delta || abs(delta) >= cols) return;
-  uint32_t newPxCol[cols];
-  for (int y = 0; y < rows; y++) {
-    if (delta > 0) {
-      for (int x = 0; x < cols-delta; x++)    newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = cols-delta; x < cols; x++) newPxCol[x] = getPixelColorXY(wrap ? (x + delta) - cols : x, y);
-    } else {
-      for (int x = cols-1; x >= -delta; x--) newPxCol[x] = getPixelColorXY((x + delta), y);
-      for (int x = -delta-1; x >= 0; x--)    newPxCol[x] = getPixelColorXY(wrap ? (x + delta) + cols : x, y);
+  if (abs(dx) >= cols) dx = 0;
+  if (abs(dy) >= rows) dy = 0;
+  if (!dx && !dy) return;
+  const int ady = abs(dy);
+  // with wrap the first (or last) |dy| rows are overwritten before they are read, keep a copy of them
+  uint32_t *saved = nullptr;
+  if (wrap && dy) {
+    saved = (uint32_t *)malloc(ady * cols * sizeof(uint32_t));
+    if (!saved) {
+      // not enough RAM, fall back to two passes
+      moveXY(dx, 0, wrap);
+      for (int x = 0; x < cols; x++) {
+        uint32_t newPxCol[rows];
+        for (int y = 0; y < rows; y++) {
+          int sy = y + dy;
+          if (sy < 0 || sy >= rows) sy = sy < 0 ? sy + rows : sy - rows;
+          newPxCol[y] = getPixelColorXY(x, sy);
+        }
+        for (int y = 0; y < rows; y++) setPixelColorXY(x, y, newPxCol[y]);
+      }
+      return;
     }
-    for (int x = 0; x < cols; x++) setPixelColorXY(x, y, newPxCol[x]);
+    const int firstSaved = dy > 0 ? 0 : rows - ady;
+    for (int r = 0; r < ady; r++) for (int x = 0; x < cols; x++) saved[r * cols + x] = getPixelColorXY(x, firstSaved + r);
   }
-}
-
-void Segment::moveY(int8_t delta, bool wrap) {
-  if (!isActive()) return; // not active
-  const int cols = virtualWidth();
-  const int rows = virtualHeight();
-  if (!delta || abs(delta) >= rows) return;
-  uint32_t newPxCol[rows];
-  for (int x = 0; x < cols; x++) {
-    if (delta > 0) {
-      for (int y = 0; y < rows-delta; y++)    newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = rows-delta; y < rows; y++) newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) - rows : y);
+  uint32_t rowPx[cols];
+  // process rows in an order where the source row has not been overwritten yet
+  for (int i = 0; i < rows; i++) {
+    const int y = dy >= 0 ? i : rows - 1 - i;
+    int sy = y + dy;
+    bool fromSaved = false;
+    if (sy < 0 || sy >= rows) {
+      if (wrap) { sy = sy < 0 ? sy + rows : sy - rows; fromSaved = true; }
+      else      sy = y; // keep exposed row
+    }
+    if (fromSaved) {
+      const int r = dy > 0 ? sy : sy - (rows - ady);
+      memcpy(rowPx, &saved[r * cols], cols * sizeof(uint32_t));
     } else {
-      for (int y = rows-1; y >= -delta; y--) newPxCol[y] = getPixelColorXY(x, (y + delta));
-      for (int y = -delta-1; y >= 0; y--)    newPxCol[y] = getPixelColorXY(x, wrap ? (y + delta) + rows : y);
+      for (int x = 0; x < cols; x++) rowPx[x] = getPixelColorXY(x, sy);
+    }
+    for (int x = 0; x < cols; x++) {
+      int sx = x + dx;
+      if (sx < 0 || sx >= cols) {
+        if (wrap) sx = sx < 0 ? sx + cols : sx - cols;
+        else      sx = x; // keep exposed column
+      }
+      if (sy == y && sx == x && !fromSaved) continue; // pixel does not change
+      setPixelColorXY(x, y, rowPx[sx]);
     }
-    for (int y = 0; y < rows; y++) setPixelColorXY(x, y, newPxCol[y]);
   }
+  free(saved);
 }
 
 // move() - move all pixels in desired direction delta number of pixels
@@ -491,15 +556,16 @@ void Segment::moveY(int8_t delta, bool wrap) {
 // @param wrap around
 void Segment::move(uint8_t dir, uint8_t delta, bool wrap) {
   if (delta==0) return;
+  const int8_t d = delta, nd = -delta; // same as moveX()/moveY(): deltas are signed 8 bit (255 = -1)
   switch (dir) {
-    case 0: moveX( delta, wrap);                      break;
-    case 1: moveX( delta, wrap); moveY( delta, wrap); break;
-    case 2:                      moveY( delta, wrap); break;
-    case 3: moveX(-delta, wrap); moveY( delta, wrap); break;
-    case 4: moveX(-delta, wrap);                      break;
-    case 5: moveX(-delta, wrap); moveY(-delta, wrap); break;
-    case 6:                      moveY(-delta, wrap); break;
-    case 7: moveX( delta, wrap); moveY(-delta, wrap); break;
+    case 0: moveXY( d,  0, wrap); break;
+    case 1: moveXY( d,  d, wrap); break;
+    case 2: moveXY( 0,  d, wrap); break;
+    case 3: moveXY(nd,  d, wrap); break;
+    case 4: moveXY(nd,  0, wrap); break;
+    case 5: moveXY(nd, nd, wrap); break;
+    case 6: moveXY( 0, nd, wrap); break;
+    case 7: moveXY( d, nd, wrap); break;
   }
 }
 
@@ -701,4 +767,151 @@ void Segment::wu_pixel(uint32_t x, uint32_t y, CRGB c) {      //awesome wu_pixel
 }
 #undef WU_WEIGHT
 
+/*
+ * Anti-aliased vector primitives
+ * All coordinates, widths and radii are 24.8 fixed point (1 pixel = 256) in virtual segment space.
+ * Coverage is computed per pixel (AA_SUBSCANLINES vertical samples with exact horizontal span coverage)
+ * and used to blend the color over existing content; fully covered pixels are written directly.
+ */
+#define AA_SUBSCANLINES 4
+
+// blend color c into pixel with coverage cov (0-256)
+void Segment::coverPixelXY(int x, int y, uint32_t c, unsigned cov) {
+  if (cov == 0) return;
+  if (cov >= 255) setPixelColorXY(x, y, c);
+  else            setPixelColorXY(x, y, color_blend(getPixelColorXY(x, y), c, cov));
+}
+
+// scanline polygon fill (even-odd rule) using an edge list; pts = {x0,y0, x1,y1, ...}, n = number of vertices
+void Segment::fillPolygon(const int32_t *pts, unsigned n, uint32_t c) {
+  if (!isActive() || !pts || n < 3) return; // not active
+  const int cols = virtualWidth();
+  const int rows = virtualHeight();
+  int32_t minY = pts[1], maxY = pts[1];
+  for (unsigned i = 1; i < n; i++) {
+    minY = min(minY, pts[2*i+1]);
+    maxY = max(maxY, pts[2*i+1]);
+  }
+  const int yStart = max(0, int(minY >> 8));
+  const int yEnd   = min(rows - 1, int(maxY >> 8));
+  if (yStart > yEnd) return; // off-screen
+
+  uint16_t cov[cols];
+  int32_t  xs[n];
+  const int32_t xLimit = int32_t(cols) << 8;
+  for (int y = yStart; y <= yEnd; y++) {
+    memset(cov, 0, sizeof(cov));
+    int covMin = cols, covMax = -1;
+    for (unsigned s = 0; s < AA_SUBSCANLINES; s++) {
+      const int32_t sy = (int32_t(y) << 8) + (s * 256 + 128) / AA_SUBSCANLINES; // sub-scanline center
+      // collect edge crossings (half-open on y so shared vertices are counted once)
+      unsigned nx = 0;
+      for (unsigned i = 0, j = n - 1; i < n; j = i++) {
+        const int32_t ay = pts[2*j+1], by = pts[2*i+1];
+        if ((ay <= sy) == (by <= sy)) continue;
+        const int32_t ax = pts[2*j], bx = pts[2*i];
+        xs[nx++] = ax + int32_t((int64_t(sy - ay) * (bx - ax)) / (by - ay));
+      }
+      // sort crossings (insertion sort, n is small)
+      for (unsigned i = 1; i < nx; i++) {
+        int32_t v = xs[i];
+        int k = i - 1;
+        while (k >= 0 && xs[k] > v) { xs[k+1] = xs[k]; k--; }
+        xs[k+1] = v;
+      }
+      // accumulate horizontal coverage of each span
+      for (unsigned i = 0; i + 1 < nx; i += 2) {
+        const int32_t xa = constrain(xs[i],   int32_t(0), xLimit);
+        const int32_t xb = constrain(xs[i+1], int32_t(0), xLimit);
+        if (xb <= xa) continue;
+        const int pa = xa >> 8, pb = xb >> 8;
+        if (pa == pb) {
+          cov[pa] += (xb - xa) / AA_SUBSCANLINES;
+        } else {
+          cov[pa] += (256 - (xa & 0xFF)) / AA_SUBSCANLINES;
+          for (int p = pa + 1; p < pb; p++) cov[p] += 256 / AA_SUBSCANLINES;
+          if (pb < cols) cov[pb] += (xb & 0xFF) / AA_SUBSCANLINES;
+        }
+        covMin = min(covMin, pa);
+        covMax = max(covMax, min(pb, cols - 1));
+      }
+    }
+    for (int x = covMin; x <= covMax; x++) coverPixelXY(x, y, c, cov[x]);
+  }
+}
+
+// line of given width (butt caps)
+void Segment::drawThickLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t width, uint32_t c) {
+  if (!isActive() || width == 0) return; // not active
+  const float dx = x1 - x0, dy = y1 - y0;
+  const float len = sqrtf(dx*dx + dy*dy);
+  const int32_t hw = width / 2; // 24.8 (32 bit: widths of 256 pixels and more do not fit 16 bit)
+  if (len < 1.0f) {
+    // degenerate line, draw a square around the point
+    int32_t pts[8] = { x0-hw, y0-hw, x0+hw, y0-hw, x0+hw, y0+hw, x0-hw, y0+hw };
+    fillPolygon(pts, 4, c);
+    return;
+  }
+  const int32_t nx = int32_t(-dy * hw / len), ny = int32_t(dx * hw / len); // half width normal
+  int32_t pts[8] = { x0+nx, y0+ny, x1+nx, y1+ny, x1-nx, y1-ny, x0-nx, y0-ny };
+  fillPolygon(pts, 4, c);
+}
+
+// connected thick lines; pts = {x0,y0, x1,y1, ...}, n = number of points
+void Segment::drawPolyline(const int32_t *pts, unsigned n, uint16_t width, uint32_t c) {
+  if (!pts) return;
+  for (unsigned i = 1; i < n; i++) drawThickLine(pts[2*i-2], pts[2*i-1], pts[2*i], pts[2*i+1], width, c);
+}
+
+// ring/arc between radius r0 and r1 (r0 = 0 for a filled disc/pie)
+// angles a0-a1 are 0-65535 (full circle), clockwise from 3 o'clock; a0 == a1 draws the full ring
+void Segment::drawArc(int32_t cx, int32_t cy, uint32_t r0, uint32_t r1, uint16_t a0, uint16_t a1, uint32_t c) {
+  if (!isActive() || r1 <= r0) return; // not active
+  const int cols = virtualWidth();
+  const int rows = virtualHeight();
+  const int xStart = max(0, int((cx - int32_t(r1)) >> 8)), xEnd = min(cols - 1, int((cx + int32_t(r1)) >> 8));
+  const int yStart = max(0, int((cy - int32_t(r1)) >> 8)), yEnd = min(rows - 1, int((cy + int32_t(r1)) >> 8));
+  const bool full = (a0 == a1);
+  const uint16_t span = a1 - a0;
+  for (int y = yStart; y <= yEnd; y++) {
+    const float dy = (int32_t(y) << 8) + 128 - cy;
+    for (int x = xStart; x <= xEnd; x++) {
+      const float dx = (int32_t(x) << 8) + 128 - cx;
+      const int d = int(sqrtf(dx*dx + dy*dy)); // distance of pixel center, 24.8
+      // coverage: 1 pixel wide soft edge at outer (and inner) radius
+      int cov = constrain(int(r1) - d + 128, 0, 256);
+      if (r0) cov = cov * constrain(d - int(r0) + 128, 0, 256) >> 8;
+      if (!cov) continue;
+      if (!full) {
+        uint16_t a = uint16_t(int(atan2f(dy, dx) * (32768.0f / float(M_PI))));
+        if (uint16_t(a - a0) > span) continue;
+      }
+      coverPixelXY(x, y, c, cov);
+    }
+  }
+}
+
+// gradient fill of the whole segment from c0 at (x0,y0) to c1 at (x1,y1)
+// radial gradient uses (x0,y0) as center and distance to (x1,y1) as radius
+void Segment::fillGradient(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t c0, uint32_t c1, bool radial) {
+  if (!isActive()) return; // not active
+  const int cols = virtualWidth();
+  const int rows = virtualHeight();
+  const int64_t gx = x1 - x0, gy = y1 - y0;
+  const int64_t len2 = gx*gx + gy*gy;
+  if (len2 == 0) { fill(c1); return; }
+  const float len = sqrtf(float(len2));
+  for (int y = 0; y < rows; y++) {
+    const int64_t py = (int64_t(y) << 8) + 128 - y0;
+    for (int x = 0; x < cols; x++) {
+      const int64_t px = (int64_t(x) << 8) + 128 - x0;
+      int t; // 0-65535 position along gradient
+      if (radial) t = int(sqrtf(float(px*px + py*py)) * 65535.0f / len);
+      else        t = int(((px*gx + py*gy) * 65535) / len2);
+      setPixelColorXY(x, y, color_blend(c0, c1, constrain(t, 0, 65535), true));
+    }
+  }
+}
+#undef AA_SUBSCANLINES
+
 #endif // WLED_DISABLE_2D
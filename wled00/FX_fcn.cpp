@@ -69,12 +69,20 @@ static constexpr bool validatePinsAndTypes(const unsigned* types, unsigned numTy
 uint16_t Segment::_usedSegmentData = 0U; // amount of RAM all segments use for their data[]
 uint16_t Segment::maxWidth = DEFAULT_LED_COUNT;
 uint16_t Segment::maxHeight = 1;
+bool     Segment::resetPending = false;
+volatile bool Segment::rtPending = false;
+#ifdef ARDUINO_ARCH_ESP32
+portMUX_TYPE  Segment::rtMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+uint32_t Segment::_pixelMapGeneration = 1;
 
 CRGBPalette16 Segment::_currentPalette    = CRGBPalette16(CRGB::Black);
 CRGBPalette16 Segment::_randomPalette     = generateRandomPalette();  // was CRGBPalette16(DEFAULT_COLOR);
 CRGBPalette16 Segment::_newRandomPalette  = generateRandomPalette();  // was CRGBPalette16(DEFAULT_COLOR);
 uint16_t      Segment::_lastPaletteChange = 0; // perhaps it should be per segment
 uint16_t      Segment::_lastPaletteBlend  = 0; //in millis (lowest 16 bits only)
+uint32_t     *Segment::_paletteLUT        = nullptr;
+unsigned long Segment::_paletteLUTUsed    = 0;
 
 #ifndef WLED_DISABLE_MODE_BLEND
 bool Segment::_modeBlend = false;
@@ -86,8 +94,11 @@ Segment::Segment(const Segment &orig) {
   memcpy((void*)this, (void*)&orig, sizeof(Segment));
   _t = nullptr; // copied segment cannot be in transition
   name = nullptr;
+  resetPending = true; // copy has to be rendered
   data = nullptr;
   _dataLen = 0;
+  _pixelMap = nullptr; // will be rebuilt on demand
+  _pixelMapGen = 0;
   if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
   if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
 }
@@ -100,21 +111,27 @@ Segment::Segment(Segment &&orig) noexcept {
   orig.name = nullptr;
   orig.data = nullptr;
   orig._dataLen = 0;
+  orig._pixelMap = nullptr;
+  orig._pixelMapGen = 0;
 }
 
 // copy assignment
 Segment& Segment::operator= (const Segment &orig) {
   //DEBUG_PRINTF_P(PSTR("-- Copying segment: %p -> %p\n"), &orig, this);
   if (this != &orig) {
+    resetPending = true; // changed segment has to be rendered
     // clean destination
     if (name) { delete[] name; name = nullptr; }
     stopTransition();
     deallocateData();
+    freePixelMap();
     // copy source
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     // erase pointers to allocated data
     data = nullptr;
     _dataLen = 0;
+    _pixelMap = nullptr;
+    _pixelMapGen = 0;
     // copy source data
     if (orig.name) { name = new char[strlen(orig.name)+1]; if (name) strcpy(name, orig.name); }
     if (orig.data) { if (allocateData(orig._dataLen)) memcpy(data, orig.data, orig._dataLen); }
@@ -129,15 +146,34 @@ Segment& Segment::operator= (Segment &&orig) noexcept {
     if (name) { delete[] name; name = nullptr; } // free old name
     stopTransition();
     deallocateData(); // free old runtime data
+    freePixelMap();
     memcpy((void*)this, (void*)&orig, sizeof(Segment));
     orig.name = nullptr;
     orig.data = nullptr;
     orig._dataLen = 0;
+    orig._pixelMap = nullptr;
+    orig._pixelMapGen = 0;
     orig._t   = nullptr; // old segment cannot be in transition
   }
   return *this;
 }
 
+// returns copy of segment settings without effect runtime data (not counted against MAX_SEGMENT_DATA)
+// the copy is marked for reset so effect restarts when it is used
+Segment Segment::cloneSettings() const {
+  Segment copy;
+  memcpy((void*)&copy, (const void*)this, sizeof(Segment));
+  copy._t   = nullptr;
+  copy.name = nullptr;
+  copy.data = nullptr;
+  copy._dataLen = 0;
+  copy._pixelMap = nullptr;
+  copy._pixelMapGen = 0;
+  if (name) { copy.name = new char[strlen(name)+1]; if (copy.name) strcpy(copy.name, name); }
+  copy.markForReset();
+  return copy;
+}
+
 // allocates effect data buffer on heap and initialises (erases) it
 bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
   if (len == 0) return false; // nothing to do
@@ -147,17 +183,19 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
   }
   //DEBUG_PRINTF_P(PSTR("--   Allocating data (%d): %p\n", len, this);
   deallocateData(); // if the old buffer was smaller release it first
-  if (Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA) {
+  // do not use SPI RAM on ESP32 since it is slow (effects access their data on every frame)
+  // MAX_SEGMENT_DATA limits effect data in internal RAM only, PSRAM is used only beyond that
+  bool overBudget = Segment::getUsedSegmentData() + len > MAX_SEGMENT_DATA;
+  data = (byte*)allocMem(len, overBudget ? MEM_BULK : MEM_HOT, MEM_OWNER_SEGMENT);
+  if (data && overBudget && !isPSRAM(data)) { freeMem(data); data = nullptr; }
+  if (!data) {
     // not enough memory
     DEBUG_PRINT(F("!!! Effect RAM depleted: "));
     DEBUG_PRINTF_P(PSTR("%d/%d !!!\n"), len, Segment::getUsedSegmentData());
     errorFlag = ERR_NORAM;
     return false;
   }
-  // do not use SPI RAM on ESP32 since it is slow
-  data = (byte*)calloc(len, sizeof(byte));
-  if (!data) { DEBUG_PRINTLN(F("!!! Allocation failed. !!!")); return false; } // allocation failed
-  Segment::addUsedSegmentData(len);
+  if (!isPSRAM(data)) Segment::addUsedSegmentData(len);
   //DEBUG_PRINTF_P(PSTR("---  Allocated data (%p): %d/%d -> %p\n"), this, len, Segment::getUsedSegmentData(), data);
   _dataLen = len;
   return true;
@@ -166,8 +204,14 @@ bool IRAM_ATTR_YN Segment::allocateData(size_t len) {
 void IRAM_ATTR_YN Segment::deallocateData() {
   if (!data) { _dataLen = 0; return; }
   //DEBUG_PRINTF_P(PSTR("---  Released data (%p): %d/%d -> %p\n"), this, _dataLen, Segment::getUsedSegmentData(), data);
+  if (isPSRAM(data)) { // PSRAM is not accounted in UsedSegmentData
+    freeMem(data);
+    data = nullptr;
+    _dataLen = 0;
+    return;
+  }
   if ((Segment::getUsedSegmentData() > 0) && (_dataLen > 0)) { // check that we don't have a dangling / inconsistent data pointer
-    free(data);
+    freeMem(data);
   } else {
     DEBUG_PRINTF_P(PSTR("---- Released data (%p): inconsistent UsedSegmentData (%d/%d), cowardly refusing to free nothing.\n"), this, _dataLen, Segment::getUsedSegmentData());
   }
@@ -285,7 +329,7 @@ void Segment::startTransition(uint16_t dur) {
     _t->_segT._dataLenT = 0;
     _t->_segT._dataT    = nullptr;
     if (_dataLen > 0 && data) {
-      _t->_segT._dataT = (byte *)malloc(_dataLen);
+      _t->_segT._dataT = (byte *)allocMem(_dataLen, MEM_HOT, MEM_OWNER_TRANSITION); // swapped in every frame, SPI RAM is slow
       if (_t->_segT._dataT) {
         //DEBUG_PRINTF_P(PSTR("--  Allocated duplicate data (%d) for %p: %p\n"), _dataLen, this, _t->_segT._dataT);
         memcpy(_t->_segT._dataT, data, _dataLen);
@@ -300,13 +344,22 @@ void Segment::startTransition(uint16_t dur) {
 #endif
 }
 
+void Segment::restore(const Segment &orig, uint16_t dur) {
+  if (this == &orig) return;
+  startTransition(dur); // stores current look
+  Transition *t = _t;
+  _t = nullptr;         // keep transition through copy assignment
+  *this = orig;
+  _t = t;
+}
+
 void Segment::stopTransition() {
   if (isInTransition()) {
     //DEBUG_PRINTF_P(PSTR("-- Stopping transition: %p\n"), this);
     #ifndef WLED_DISABLE_MODE_BLEND
     if (_t->_segT._dataT && _t->_segT._dataLenT > 0) {
       //DEBUG_PRINTF_P(PSTR("--  Released duplicate data (%d) for %p: %p\n"), _t->_segT._dataLenT, this, _t->_segT._dataT);
-      free(_t->_segT._dataT);
+      freeMem(_t->_segT._dataT);
       _t->_segT._dataT = nullptr;
       _t->_segT._dataLenT = 0;
     }
@@ -484,6 +537,7 @@ void Segment::setUp(uint16_t i1, uint16_t i2, uint8_t grp, uint8_t spc, uint16_t
   DEBUG_PRINT(','); DEBUG_PRINTLN(i2Y);
   markForReset();
   if (boundsUnchanged) return;
+  freePixelMap(); // segment rectangle changed
 
   // apply change immediately
   if (i2 <= i1) { //disable segment
@@ -547,6 +601,7 @@ Segment &Segment::setOpacity(uint8_t o) {
 }
 
 Segment &Segment::setOption(uint8_t n, bool val) {
+  if (getOption(n) == val) return *this; // no change
   bool prevOn = on;
   if (fadeTransition && n == SEG_OPTION_ON && val != prevOn) startTransition(strip.getTransition()); // start transition prior to change
   if (val) options |=   0x01 << n;
@@ -968,6 +1023,11 @@ uint8_t Segment::differs(Segment& b) const {
   if (custom3 != b.custom3)     d |= SEG_DIFFERS_FX;
   if (startY != b.startY)       d |= SEG_DIFFERS_BOUNDS;
   if (stopY != b.stopY)         d |= SEG_DIFFERS_BOUNDS;
+  if (fps != b.fps)             d |= SEG_DIFFERS_OPT;
+  if (priority != b.priority)   d |= SEG_DIFFERS_OPT;
+  if (rtProto != b.rtProto)     d |= SEG_DIFFERS_OPT;
+  if (rtStart != b.rtStart)     d |= SEG_DIFFERS_OPT;
+  if (rtTimeout != b.rtTimeout) d |= SEG_DIFFERS_OPT;
 
   //bit pattern: (msb first)
   // set:2, sound:2, mapping:3, transposed, mirrorY, reverseY, [reset,] paused, mirrored, on, reverse, [selected]
@@ -1174,6 +1234,30 @@ uint32_t Segment::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_
   return RGBW32(fastled_col.r, fastled_col.g, fastled_col.b, W(color));
 }
 
+/*
+ * Expands current (possibly blended) palette into 256 entry table once per call so that effects which
+ * calculate a palette index for each pixel only need a table lookup (same as color_from_palette(idx, false, wrap, mcol)).
+ * This only moves palette interpolation out of the per pixel loop: pixels are still stored as 32 bit colors.
+ * Table is shared by all segments and must be requested each frame; its content is valid until next call.
+ * It is freed by releasePaletteLUT() once no effect uses it any more.
+ * Returns nullptr if segment has too few pixels to benefit or if table cannot be allocated.
+ */
+const uint32_t *Segment::getPaletteLUT(bool wrap, uint8_t mcol) const {
+  unsigned len = is2D() ? virtualWidth() * virtualHeight() : virtualLength();
+  if (len <= 256) return nullptr;
+  if (!_paletteLUT) _paletteLUT = static_cast<uint32_t*>(allocMem(256 * sizeof(uint32_t), MEM_HOT, MEM_OWNER_PALETTE));
+  if (!_paletteLUT) return nullptr;
+  _paletteLUTUsed = millis();
+  for (unsigned i = 0; i < 256; i++) _paletteLUT[i] = color_from_palette(i, false, wrap, mcol);
+  return _paletteLUT;
+}
+
+void Segment::releasePaletteLUT(unsigned long now) {
+  if (!_paletteLUT || now - _paletteLUTUsed < 1000) return;
+  freeMem(_paletteLUT);
+  _paletteLUT = nullptr;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // WS2812FX class implementation
@@ -1306,14 +1390,97 @@ void WS2812FX::finalizeInit() {
   deserializeMap();     // (re)load default ledmap (will also setUpMatrix() if ledmap does not exist)
 }
 
+static uint32_t realtimeFirstPixel(const Segment &seg) {
+  return (seg.rtProto == REALTIME_MODE_E131 || seg.rtProto == REALTIME_MODE_ARTNET) ? seg.rtStart * MAX_3_CH_LEDS_PER_UNIVERSE : seg.rtStart;
+}
+
+// rebuilds realtime bindings table if bound segments changed (loop task only)
+// new table is published under SEG_RT_LOCK so network task never sees a table that is being built or freed
+void WS2812FX::updateRealtimeBindings() {
+  unsigned count = 0;
+  bool changed = false;
+  for (size_t s = 0; s < _segments.size(); s++) {
+    const Segment &seg = _segments[s];
+    if (!seg.rtProto || !seg.isActive()) continue;
+    if (count >= _rtBindingCount) changed = true;
+    else {
+      const rt_binding_t &b = _rtBindings[count];
+      changed |= b.segment != s || b.proto != seg.rtProto || b.first != realtimeFirstPixel(seg) || b.len != seg.virtualLength() || b.timeout != seg.rtTimeout;
+    }
+    count++;
+  }
+  if (!changed && count == _rtBindingCount) return;
+
+  // one block: bindings, then pixel buffers, then sequence numbers
+  size_t size = count * sizeof(rt_binding_t);
+  for (const segment &seg : _segments) {
+    if (!seg.rtProto || !seg.isActive()) continue;
+    size += seg.virtualLength() * sizeof(uint32_t);
+    if (seg.rtProto == REALTIME_MODE_E131 || seg.rtProto == REALTIME_MODE_ARTNET) size += (seg.virtualLength() + MAX_3_CH_LEDS_PER_UNIVERSE - 1) / MAX_3_CH_LEDS_PER_UNIVERSE;
+  }
+  rt_binding_t *table = count ? static_cast<rt_binding_t*>(allocMem(size, MEM_HOT, MEM_OWNER_SEGMENT)) : nullptr;
+  if (table) {
+    memset(table, 0, size);
+    uint32_t *pixels = reinterpret_cast<uint32_t*>(table + count);
+    unsigned n = 0;
+    for (size_t s = 0; s < _segments.size(); s++) {
+      const Segment &seg = _segments[s];
+      if (!seg.rtProto || !seg.isActive()) continue;
+      rt_binding_t &b = table[n++];
+      b.data    = pixels;
+      b.until   = seg.rtUntil; // keep showing realtime data if only segment size changed
+      b.first   = realtimeFirstPixel(seg);
+      b.len     = seg.virtualLength();
+      b.timeout = seg.rtTimeout;
+      b.proto   = seg.rtProto;
+      b.segment = s;
+      pixels   += b.len;
+    }
+    uint8_t *seq = reinterpret_cast<uint8_t*>(pixels);
+    for (unsigned i = 0; i < count; i++) {
+      if (table[i].proto != REALTIME_MODE_E131 && table[i].proto != REALTIME_MODE_ARTNET) continue;
+      table[i].seq = seq;
+      seq += (table[i].len + MAX_3_CH_LEDS_PER_UNIVERSE - 1) / MAX_3_CH_LEDS_PER_UNIVERSE;
+    }
+  } else count = 0; // out of memory: bound sources are handled by strip wide realtime mode
+
+  SEG_RT_LOCK();
+  rt_binding_t *old = _rtBindings;
+  _rtBindings     = table;
+  _rtBindingCount = count;
+  SEG_RT_UNLOCK();
+  freeMem(old);
+}
+
 void WS2812FX::service() {
   unsigned long nowUp = millis(); // Be aware, millis() rolls over every 49 days
   now = nowUp + timebase;
   if (nowUp - _lastShow < MIN_SHOW_DELAY || _suspend) return;
   bool doShow = false;
 
+  bool fadeShow = _fadeDuration && applyFade(nowUp); // may trigger redraw of all segments
+
+  // nothing is due: skip walking all segments (matters with large segment counts)
+  if (!_triggered && !Segment::resetPending && !Segment::rtPending && nowUp <= _nextDue) {
+    if (fadeShow) show(); // buffered pixels are only re-sent with new brightness
+    return;
+  }
+  Segment::resetPending = false;
+  Segment::rtPending = false;
+  updateRealtimeBindings();
+  unsigned long nextDue = nowUp + 1000; // re-check at least every second
+
+  // frame budget: time reserved for due top priority segments is not available to others
+  const unsigned long startUs = micros();
+  const unsigned long budget  = (_frameBudget ? _frameBudget : _frametime) * 1000UL;
+  unsigned long reserved = 0;
+  for (const segment &seg : _segments) {
+    if (seg.isActive() && seg.priority >= SEG_PRIORITY_MAX && nowUp > seg.next_time) reserved += seg.renderTime;
+  }
+
   _isServicing = true;
   _segment_index = 0;
+  unsigned rtNext = 0; // next realtime binding
 
   for (segment &seg : _segments) {
     if (_suspend) return; // immediately stop processing segments if suspend requested during service()
@@ -1323,15 +1490,41 @@ void WS2812FX::service() {
     // reset the segment runtime data if needed
     seg.resetIfRequired();
 
-    if (!seg.isActive()) continue;
+    if (!seg.isActive()) {
+      _segment_index++; // keep index in sync with segment for SEGMENT macro
+      continue;
+    }
+
+    // bindings are ordered like segments, table only changes on this task
+    rt_binding_t *rt = nullptr;
+    if (rtNext < _rtBindingCount && _rtBindings[rtNext].segment == _segment_index) {
+      rt = &_rtBindings[rtNext++];
+      seg.rtUntil = rt->until; // aligned 32 bit value written by network task
+    }
 
     // last condition ensures all solid segments are updated at the same time
     if (nowUp > seg.next_time || _triggered || (doShow && seg.mode == FX_MODE_STATIC))
     {
+      if (seg.priority >= SEG_PRIORITY_MAX) {
+        reserved -= min(reserved, (unsigned long)seg.renderTime);
+      } else if (!_triggered && (doShow || reserved) && seg.deferred < (SEG_MAX_DEFER >> seg.priority)
+                 && micros() - startUs + seg.renderTime + reserved > budget) {
+        seg.deferred++; // postpone to next frame (next_time unchanged)
+        nextDue = nowUp;
+        _segment_index++;
+        continue;
+      }
+      seg.deferred = 0;
       doShow = true;
       unsigned frameDelay = FRAMETIME;
 
-      if (!seg.freeze) { //only run effect function if not frozen
+      if (seg.isLive(nowUp)) { // showing realtime data instead of effect
+        if (rt && rt->fresh) {
+          rt->fresh = false; // cleared before drawing so data arriving meanwhile is drawn again
+          for (unsigned i = 0; i < rt->len; i++) seg.setPixelColor(int(i), rt->data[i]);
+        }
+      } else if (!seg.freeze) { //only run effect function if not frozen
+        unsigned long renderStart = micros();
         int oldCCT = BusManager::getSegmentCCT(); // store original CCT value (actually it is not Segment based)
         _virtualSegmentLength = seg.virtualLength(); //SEGLEN
         _colors_t[0] = gamma32(seg.currentColor(0));
@@ -1364,21 +1557,27 @@ void WS2812FX::service() {
 #endif
         seg.call++;
         if (seg.isInTransition() && frameDelay > FRAMETIME) frameDelay = FRAMETIME; // force faster updates during transition
+        else if (seg.fps && frameDelay < 1000U/seg.fps) frameDelay = 1000U/seg.fps; // limit segment to its target rate
         BusManager::setSegmentCCT(oldCCT); // restore old CCT for ABL adjustments
+        unsigned long renderTime = min(micros() - renderStart, 65535UL);
+        seg.renderTime = (3 * seg.renderTime + renderTime + 2) / 4; // moving average
       }
 
       seg.next_time = nowUp + frameDelay;
     }
+    if (seg.next_time < nextDue) nextDue = seg.next_time;
     _segment_index++;
   }
+  _nextDue = nextDue;
   _virtualSegmentLength = 0;
+  Segment::releasePaletteLUT(nowUp);
   _isServicing = false;
   _triggered = false;
 
   #ifdef WLED_DEBUG
   if (millis() - nowUp > _frametime) DEBUG_PRINTF_P(PSTR("Slow effects %u/%d.\n"), (unsigned)(millis()-nowUp), (int)_frametime);
   #endif
-  if (doShow) {
+  if (doShow || fadeShow) {
     yield();
     Segment::handleRandomPalette(); // slowly transition random palette; move it into for loop when each segment has individual random palette
     show();
@@ -1437,6 +1636,61 @@ uint16_t WS2812FX::getFps() const {
   return (FPS_MULTIPLIER * _cumulativeFps) >> FPS_CALC_SHIFT; // _cumulativeFps is stored in fixed point
 }
 
+void WS2812FX::startFade(uint8_t briFrom, uint8_t briTo, uint32_t duration, uint32_t colFrom, uint32_t colTo, bool fadeColor) {
+  _fadeStart    = millis();
+  _fadeDuration = duration ? duration : 1;
+  _fadeBriFrom  = briFrom;
+  _fadeBriTo    = briTo;
+  _fadeColFrom  = colFrom;
+  _fadeColTo    = colTo;
+  _fadeColor    = fadeColor;
+}
+
+// interpolates brightness (and color of selected segments) for the current frame
+// values are calculated in 8.8 fixed point, brightness is dithered over 16 frames so slow fades do not show 8 bit steps
+// dithering needs pixels re-sent from the LED buffer, without it brightness is stepped and picked up as effects redraw
+// returns true if only bus brightness changed and buffered pixels need to be shown again
+bool WS2812FX::applyFade(unsigned long nowUp) {
+  static const uint8_t dither[16] = {0,128,64,192,32,160,96,224,16,144,80,208,48,176,112,240}; // bit reversed order
+  unsigned long elapsed = nowUp - _fadeStart;
+  bool done = elapsed >= _fadeDuration;
+  int progress = done ? 65536 : ((uint64_t)elapsed << 16) / _fadeDuration; // 0-65536
+  unsigned d = done || !useGlobalLedBuffer ? 128 : dither[_fadeFrame++ & 0x0F]; // 128: round to nearest
+  if (done) _fadeDuration = 0;
+
+  const unsigned src = (_fadeBriFrom << 8) + (((_fadeBriTo - _fadeBriFrom) * progress) >> 8);
+  unsigned b = src;
+  if (gammaCorrectBri) b = (perceptualToLinear16(src, true) * 255U + 128) >> 8; // 16 bit gamma curve, scaled to 8.8
+  uint8_t bri = min((b + d) >> 8, 255U);
+  Bus::setBrightnessSource(src, gammaCorrectBri, bri); // PWM outputs do not need dithering
+  bool reshow = false;
+  if (bri != _brightness) {
+    _brightness = bri;
+    BusManager::setBrightness(bri);
+    reshow = useGlobalLedBuffer; // buses with a pixel buffer re-apply brightness on show()
+  }
+
+  if (!_fadeColor) return reshow;
+  // color is an effect input: not dithered, segments are only redrawn when the 8 bit value changes
+  uint32_t c = 0;
+  for (unsigned shift = 0; shift < 32; shift += 8) {
+    int from = (_fadeColFrom >> shift) & 0xFF;
+    int to   = (_fadeColTo   >> shift) & 0xFF;
+    unsigned v = (from << 8) + (((to - from) * progress) >> 8);
+    c |= min((v + 128) >> 8, 255U) << shift;
+  }
+  for (segment &seg : _segments) {
+    if (!seg.isActive() || !seg.isSelected() || seg.colors[0] == c) continue;
+    seg.colors[0] = c; // bypasses setColor() to avoid starting a transition and flagging state change
+    _triggered = true;
+  }
+  return reshow;
+}
+
+void WS2812FX::setFrameBudget(uint16_t ms) {
+  _frameBudget = min(ms, (uint16_t)1000);
+}
+
 void WS2812FX::setTargetFps(uint8_t fps) {
   if (fps > 0 && fps <= 120) _targetFps = fps;
   _frametime = 1000 / _targetFps;
@@ -1474,7 +1728,9 @@ void WS2812FX::setCCT(uint16_t k) {
 // direct=true either expects the caller to call show() themselves (realtime modes) or be ok waiting for the next frame for the change to apply
 // direct=false immediately triggers an effect redraw
 void WS2812FX::setBrightness(uint8_t b, bool direct) {
+  const uint8_t src = b;
   if (gammaCorrectBri) b = gamma8(b);
+  Bus::setBrightnessSource(src << 8, gammaCorrectBri, b); // allows PWM outputs to correct uncorrected value at 16 bit
   if (_brightness == b) return;
   _brightness = b;
   if (_brightness == 0) { //unfreeze all segments on power off
@@ -1747,56 +2003,133 @@ void WS2812FX::printSize() {
   DEBUG_PRINTF_P(PSTR("Modes: %d*%d=%uB\n"), sizeof(mode_ptr), _mode.size(), (_mode.capacity()*sizeof(mode_ptr)));
   DEBUG_PRINTF_P(PSTR("Data: %d*%d=%uB\n"), sizeof(const char *), _modeData.size(), (_modeData.capacity()*sizeof(const char *)));
   DEBUG_PRINTF_P(PSTR("Map: %d*%d=%uB\n"), sizeof(uint16_t), (int)customMappingSize, customMappingSize*sizeof(uint16_t));
+  for (unsigned o = 0; o < MEM_OWNERS; o++) DEBUG_PRINTF_P(PSTR("  Mem[%u]: %uB RAM, %uB PSRAM\n"), o, getMemUsage(o, false), getMemUsage(o, true));
 }
 #endif
 
-void WS2812FX::loadCustomPalettes() {
+// Custom palettes are compiled from /paletteN.json into a single binary store (/palettes.bin)
+// so that boot and palette edits only parse the JSON files that actually changed.
+// A file is considered changed if its size or last write time differ (files are not read to check that).
+// Store layout: 'W','P',version,count,gamma key (4 bytes) followed by one record per palette file.
+// Records hold gamma corrected entries so the store is only valid for the gamma settings it was compiled with.
+#define PAL_STORE_FILE    "/palettes.bin"
+#define PAL_STORE_VERSION 3
+
+typedef struct {
+  uint32_t key;         // size and last write time of the source JSON file
+  uint8_t  valid;       // source file had a usable palette
+  CRGB     entries[16]; // gamma corrected palette
+} __attribute__((packed)) palStoreRecord;
+
+// returns key of file size and last write time or 0 if file does not exist
+// (last write time is 0 if file system does not keep it, hence uploads recompile all palettes)
+static uint32_t customPaletteKey(const char *fileName) {
+  File f = WLED_FS.open(fileName, "r");
+  if (!f) return 0;
+  uint32_t h = (2166136261UL ^ (uint32_t)f.size()) * 16777619UL;
+  h = (h ^ (uint32_t)f.getLastWrite()) * 16777619UL;
+  f.close();
+  return h ? h : 1;
+}
+
+// returns hash of gamma settings used when compiling palettes
+// (whole table is hashed as it is not recalculated when gamma correction is turned off)
+static uint32_t customPaletteGammaKey() {
+  uint32_t h = (2166136261UL ^ gammaCorrectCol) * 16777619UL;
+  for (unsigned i = 0; i < 256; i++) h = (h ^ gamma8(i)) * 16777619UL;
+  return h;
+}
+
+// parses a single palette JSON file into a 16 entry palette
+static bool compileCustomPalette(const char *fileName, CRGB *entries) {
   byte tcp[72]; //support gradient palettes with up to 18 entries
   CRGBPalette16 targetPalette;
+  StaticJsonDocument<1536> pDoc; // barely enough to fit 72 numbers
+  DEBUG_PRINT(F("Compiling palette from "));
+  DEBUG_PRINTLN(fileName);
+  if (!readObjectFromFile(fileName, nullptr, &pDoc)) return false;
+  JsonArray pal = pDoc[F("palette")];
+  if (pal.isNull() || pal.size() <= 3) { // empty palette (less than 2 entries)
+    DEBUG_PRINTLN(F("Wrong palette format."));
+    return false;
+  }
+  if (pal[0].is<int>() && pal[1].is<const char *>()) {
+    // we have an array of index & hex strings
+    size_t palSize = MIN(pal.size(), 36);
+    palSize -= palSize % 2; // make sure size is multiple of 2
+    for (size_t i=0, j=0; i<palSize && pal[i].as<int>()<256; i+=2, j+=4) {
+      uint8_t rgbw[] = {0,0,0,0};
+      tcp[ j ] = (uint8_t) pal[ i ].as<int>(); // index
+      colorFromHexString(rgbw, pal[i+1].as<const char *>()); // will catch non-string entires
+      for (size_t c=0; c<3; c++) tcp[j+1+c] = gamma8(rgbw[c]); // only use RGB component
+      DEBUG_PRINTF_P(PSTR("%d(%d) : %d %d %d\n"), i, int(tcp[j]), int(tcp[j+1]), int(tcp[j+2]), int(tcp[j+3]));
+    }
+  } else {
+    size_t palSize = MIN(pal.size(), 72);
+    palSize -= palSize % 4; // make sure size is multiple of 4
+    for (size_t i=0; i<palSize && pal[i].as<int>()<256; i+=4) {
+      tcp[ i ] = (uint8_t) pal[ i ].as<int>(); // index
+      tcp[i+1] = gamma8((uint8_t) pal[i+1].as<int>()); // R
+      tcp[i+2] = gamma8((uint8_t) pal[i+2].as<int>()); // G
+      tcp[i+3] = gamma8((uint8_t) pal[i+3].as<int>()); // B
+      DEBUG_PRINTF_P(PSTR("%d(%d) : %d %d %d\n"), i, int(tcp[i]), int(tcp[i+1]), int(tcp[i+2]), int(tcp[i+3]));
+    }
+  }
+  targetPalette.loadDynamicGradientPalette(tcp);
+  memcpy(entries, targetPalette.entries, sizeof(targetPalette.entries));
+  return true;
+}
+
+// (re)loads custom palettes from binary store, recompiling only palette files that were added or changed
+// recompile ignores the store (i.e. after a palette file was uploaded)
+void WS2812FX::loadCustomPalettes(bool recompile) {
+  std::vector<palStoreRecord> records;
+  uint8_t hdr[4] = {0};
+  const uint32_t gammaKey = customPaletteGammaKey();
+  uint32_t storeKey = 0;
+  File f = recompile ? File() : WLED_FS.open(PAL_STORE_FILE, "r");
+  if (f) {
+    if (f.read(hdr, sizeof(hdr)) != sizeof(hdr) || hdr[0] != 'W' || hdr[1] != 'P' || hdr[2] != PAL_STORE_VERSION
+        || f.read((uint8_t*)&storeKey, sizeof(storeKey)) != sizeof(storeKey) || storeKey != gammaKey
+        || f.size() != sizeof(hdr) + sizeof(storeKey) + hdr[3] * sizeof(palStoreRecord)) hdr[3] = 0; // invalid or outdated store
+  }
+  bool dirty = false;
   customPalettes.clear(); // start fresh
   for (int index = 0; index<10; index++) {
     char fileName[32];
     sprintf_P(fileName, PSTR("/palette%d.json"), index);
-
-    StaticJsonDocument<1536> pDoc; // barely enough to fit 72 numbers
-    if (WLED_FS.exists(fileName)) {
-      DEBUG_PRINT(F("Reading palette from "));
-      DEBUG_PRINTLN(fileName);
-
-      if (readObjectFromFile(fileName, nullptr, &pDoc)) {
-        JsonArray pal = pDoc[F("palette")];
-        if (!pal.isNull() && pal.size()>3) { // not an empty palette (at least 2 entries)
-          if (pal[0].is<int>() && pal[1].is<const char *>()) {
-            // we have an array of index & hex strings
-            size_t palSize = MIN(pal.size(), 36);
-            palSize -= palSize % 2; // make sure size is multiple of 2
-            for (size_t i=0, j=0; i<palSize && pal[i].as<int>()<256; i+=2, j+=4) {
-              uint8_t rgbw[] = {0,0,0,0};
-              tcp[ j ] = (uint8_t) pal[ i ].as<int>(); // index
-              colorFromHexString(rgbw, pal[i+1].as<const char *>()); // will catch non-string entires
-              for (size_t c=0; c<3; c++) tcp[j+1+c] = gamma8(rgbw[c]); // only use RGB component
-              DEBUG_PRINTF_P(PSTR("%d(%d) : %d %d %d\n"), i, int(tcp[j]), int(tcp[j+1]), int(tcp[j+2]), int(tcp[j+3]));
-            }
-          } else {
-            size_t palSize = MIN(pal.size(), 72);
-            palSize -= palSize % 4; // make sure size is multiple of 4
-            for (size_t i=0; i<palSize && pal[i].as<int>()<256; i+=4) {
-              tcp[ i ] = (uint8_t) pal[ i ].as<int>(); // index
-              tcp[i+1] = gamma8((uint8_t) pal[i+1].as<int>()); // R
-              tcp[i+2] = gamma8((uint8_t) pal[i+2].as<int>()); // G
-              tcp[i+3] = gamma8((uint8_t) pal[i+3].as<int>()); // B
-              DEBUG_PRINTF_P(PSTR("%d(%d) : %d %d %d\n"), i, int(tcp[i]), int(tcp[i+1]), int(tcp[i+2]), int(tcp[i+3]));
-            }
-          }
-          customPalettes.push_back(targetPalette.loadDynamicGradientPalette(tcp));
-        } else {
-          DEBUG_PRINTLN(F("Wrong palette format."));
-        }
-      }
-    } else {
-      break;
+    uint32_t key = customPaletteKey(fileName);
+    if (!key) break;
+    palStoreRecord rec;
+    bool cached = f && index < hdr[3] && f.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec) && rec.key == key;
+    if (!cached) {
+      rec.key   = key;
+      rec.valid = compileCustomPalette(fileName, rec.entries);
+      dirty = true;
     }
+    records.push_back(rec);
+    if (rec.valid) {
+      CRGBPalette16 targetPalette;
+      memcpy(targetPalette.entries, rec.entries, sizeof(targetPalette.entries));
+      customPalettes.push_back(targetPalette);
+    }
+  }
+  if (f) f.close();
+  if (!dirty && records.size() == hdr[3]) return; // store is up to date (hdr[3] is 0 if gamma changed)
+
+  // rewrite store (at most 10 small records)
+  if (records.empty()) {
+    if (WLED_FS.exists(PAL_STORE_FILE)) WLED_FS.remove(PAL_STORE_FILE);
+    return;
   }
+  DEBUG_PRINTF_P(PSTR("Writing palette store (%u palettes)\n"), records.size());
+  f = WLED_FS.open(PAL_STORE_FILE, "w");
+  if (!f) return;
+  hdr[0] = 'W'; hdr[1] = 'P'; hdr[2] = PAL_STORE_VERSION; hdr[3] = records.size();
+  f.write(hdr, sizeof(hdr));
+  f.write((const uint8_t*)&gammaKey, sizeof(gammaKey));
+  f.write((const uint8_t*)records.data(), records.size() * sizeof(palStoreRecord));
+  f.close();
 }
 
 //load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
@@ -1810,6 +2143,7 @@ bool WS2812FX::deserializeMap(uint8_t n) {
   bool isFile = WLED_FS.exists(fileName);
 
   customMappingSize = 0; // prevent use of mapping if anything goes wrong
+  Segment::invalidatePixelMaps();
   currentLedmap = 0;
   if (n == 0 || isFile) interfaceUpdateCallMode = CALL_MODE_WS_SEND; // schedule WS update (to inform UI)
 
@@ -1833,8 +2167,8 @@ bool WS2812FX::deserializeMap(uint8_t n) {
     Segment::maxHeight = min(max(root[F("height")].as<int>(), 1), 128);
   }
 
-  if (customMappingTable) delete[] customMappingTable;
-  customMappingTable = new uint16_t[getLengthTotal()];
+  freeMem(customMappingTable);
+  customMappingTable = static_cast<uint16_t*>(allocMem(getLengthTotal() * sizeof(uint16_t), MEM_MAP, MEM_OWNER_LEDMAP));
 
   if (customMappingTable) {
     DEBUG_PRINT(F("Reading LED map from ")); DEBUG_PRINTLN(fileName);
@@ -7,6 +7,7 @@
 #ifdef ARDUINO_ARCH_ESP32
 #include "driver/ledc.h"
 #include "soc/ledc_struct.h"
+#include "esp_heap_caps.h"
   #if !(defined(CONFIG_IDF_TARGET_ESP32C3) || defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32S3))
     #define LEDC_MUTEX_LOCK()    do {} while (xSemaphoreTake(_ledc_sys_lock, portMAX_DELAY) != pdPASS)
     #define LEDC_MUTEX_UNLOCK()  xSemaphoreGive(_ledc_sys_lock)
@@ -25,6 +26,11 @@ extern bool cctICused;
 
 //colors.cpp
 uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb);
+uint16_t perceptualToLinear16(uint16_t v, bool gamma);
+
+//util.cpp
+void *allocMem(size_t size, uint8_t tier, uint8_t owner);
+void  freeMem(void *ptr);
 
 //udp.cpp
 uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
@@ -116,8 +122,14 @@ uint32_t Bus::autoWhiteCalc(uint32_t c) const {
 }
 
 uint8_t *Bus::allocateData(size_t size) {
-  if (_data) free(_data); // should not happen, but for safety
-  return _data = (uint8_t *)(size>0 ? calloc(size, sizeof(uint8_t)) : nullptr);
+  freeData(); // should not happen, but for safety
+  // do not use SPI RAM on ESP32 since it is slow (buffer is read on every show())
+  return _data = (uint8_t *)allocMem(size, MEM_HOT, MEM_OWNER_BUS);
+}
+
+void Bus::freeData() {
+  freeMem(_data);
+  _data = nullptr;
 }
 
 
@@ -128,6 +140,9 @@ BusDigital::BusDigital(BusConfig &bc, uint8_t nr, const ColorOrderMap &com)
 , _milliAmpsPerLed(bc.milliAmpsPerLed)
 , _milliAmpsMax(bc.milliAmpsMax)
 , _colorOrderMap(com)
+, _changed(true)
+, _milliAmpsLast(0)
+, _lastShow(0)
 {
   if (!isDigital(bc.type) || !bc.count) return;
   if (!PinManager::allocatePin(bc.pins[0], true, PinOwner::BusDigital)) return;
@@ -229,6 +244,16 @@ void BusDigital::show() {
   _milliAmpsTotal = 0;
   if (!_valid) return;
 
+  // skip sending identical frame (brightness limiting depends only on pixel data and brightness)
+  // unless LEDs need continuous refresh or keep-alive interval has elapsed
+  unsigned long now = millis();
+  if (!_changed && !_needsRefresh && _keepAlive && now - _lastShow < _keepAlive) {
+    _milliAmpsTotal = _milliAmpsLast;
+    return;
+  }
+  _changed = false;
+  _lastShow = now;
+
   uint8_t cctWW = 0, cctCW = 0;
   unsigned newBri = estimateCurrentAndLimitBri();  // will fill _milliAmpsTotal
   if (newBri < _bri) PolyBus::setBrightness(_busPtr, _iType, newBri); // limit brightness to stay within current limits
@@ -284,6 +309,7 @@ void BusDigital::show() {
   // this is done right after show, so this is only OK if LED updates are completed before show() returns
   // or async show has a separate buffer (ESP32 RMT and I2S are ok)
   if (newBri < _bri) PolyBus::setBrightness(_busPtr, _iType, _bri);
+  _milliAmpsLast = _milliAmpsTotal;
 }
 
 bool BusDigital::canShow() const {
@@ -293,6 +319,7 @@ bool BusDigital::canShow() const {
 
 void BusDigital::setBrightness(uint8_t b) {
   if (_bri == b) return;
+  _changed = true;
   Bus::setBrightness(b);
   PolyBus::setBrightness(_busPtr, _iType, b);
 }
@@ -313,16 +340,22 @@ void IRAM_ATTR BusDigital::setPixelColor(uint16_t pix, uint32_t c) {
   if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
   if (_data) {
     size_t offset = pix * getNumberOfChannels();
+    uint8_t diff = 0; // detect if pixel actually changed
     if (hasRGB()) {
-      _data[offset++] = R(c);
-      _data[offset++] = G(c);
-      _data[offset++] = B(c);
+      diff |= _data[offset] ^ R(c); _data[offset++] = R(c);
+      diff |= _data[offset] ^ G(c); _data[offset++] = G(c);
+      diff |= _data[offset] ^ B(c); _data[offset++] = B(c);
     }
-    if (hasWhite()) _data[offset++] = W(c);
+    if (hasWhite()) { diff |= _data[offset] ^ W(c); _data[offset++] = W(c); }
     // unfortunately as a segment may span multiple buses or a bus may contain multiple segments and each segment may have different CCT
     // we need to store CCT value for each pixel (if there is a color correction in play, convert K in CCT ratio)
-    if (hasCCT())   _data[offset]   = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
+    if (hasCCT()) {
+      uint8_t cct = Bus::_cct >= 1900 ? (Bus::_cct - 1900) >> 5 : (Bus::_cct < 0 ? 127 : Bus::_cct); // TODO: if _cct == -1 we simply ignore it
+      diff |= _data[offset] ^ cct; _data[offset] = cct;
+    }
+    if (diff) _changed = true;
   } else {
+    _changed = true; // without buffer comparing old pixel would be as costly as sending it
     if (_reversed) pix = _len - pix -1;
     pix += _skip;
     unsigned co = _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder);
@@ -382,6 +415,7 @@ void BusDigital::setColorOrder(uint8_t colorOrder) {
   // upper nibble contains W swap information
   if ((colorOrder & 0x0F) > 5) return;
   _colorOrder = colorOrder;
+  _changed = true;
 }
 
 // credit @willmmiles & @netmindz https://github.com/Aircoookie/WLED/pull/4056
@@ -413,6 +447,7 @@ std::vector<LEDType> BusDigital::getLEDTypes() {
 void BusDigital::reinit() {
   if (!_valid) return;
   PolyBus::begin(_busPtr, _iType, _pins);
+  _changed = true;
 }
 
 void BusDigital::cleanup() {
@@ -497,6 +532,10 @@ BusPwm::BusPwm(BusConfig &bc)
   _hasWhite = hasWhite(bc.type);
   _hasCCT = hasCCT(bc.type);
   _data = _pwmdata; // avoid malloc() and use stack
+  #ifdef ARDUINO_ARCH_ESP32
+  memset(_duty, 0, sizeof(_duty));
+  _lastShow = 0;
+  #endif
   _valid = true;
   DEBUG_PRINTF_P(PSTR("%successfully inited PWM strip with type %u, frequency %u, bit depth %u and pins %u,%u,%u,%u,%u\n"), _valid?"S":"Uns", bc.type, _frequency, _depth, _pins[0], _pins[1], _pins[2], _pins[3], _pins[4]);
 }
@@ -567,20 +606,20 @@ void BusPwm::show() {
   const unsigned maxBri = (1<<_depth);      // possible values: 16384 (14), 8192 (13), 4096 (12), 2048 (11), 1024 (10), 512 (9) and 256 (8) 
   [[maybe_unused]] const unsigned bitShift = dithering * 4;  // if dithering, _depth is 12 bit but LEDC channel is set to 8 bit (using 4 fractional bits)
 
-  // use CIE brightness formula (cubic) to fit (or approximate linearity of) human eye perceived brightness
-  // the formula is based on 12 bit resolution as there is no need for greater precision
+  // use CIE lightness curve to fit (or approximate linearity of) human eye perceived brightness
   // see: https://en.wikipedia.org/wiki/Lightness
-  unsigned pwmBri = (unsigned)_bri * 100;  // enlarge to use integer math for linear response
-  if (pwmBri < 2040) {
-    // linear response for values [0-20]
-    pwmBri = ((pwmBri << 12) + 115043) / 230087; //adding '0.5' before division for correct rounding
-  } else {
-    // cubic response for values [21-255]
-    pwmBri += 4080;
-    float temp = (float)pwmBri / 29580.0f;
-    temp = temp * temp * temp * (float)maxBri; 
-    pwmBri = (unsigned)temp;  // pwmBri is in range [0-maxBri] 
-  }
+  // if strip brightness was gamma corrected, start from uncorrected value and use 16 bit gamma curve instead
+  // so that correction is applied only once and without 8 bit quantisation at the low end
+  uint16_t luminance = (_bri == _briSrcOut) ? perceptualToLinear16(_briSrc, _briSrcGamma) : perceptualToLinear16(_bri << 8, false);
+  unsigned pwmBri = ((uint32_t)luminance * maxBri + 32767) / 65535;  // pwmBri is in range [0-maxBri]
+
+  #ifdef ARDUINO_ARCH_ESP32
+  // ramp from previous to new duty using LEDC hardware fade over (roughly) the time until next frame
+  // so brightness changes are spread over many PWM periods instead of stepping at frame rate
+  unsigned long now = millis();
+  unsigned periods = min(now - _lastShow, (unsigned long)PWM_FADE_MAX_MS) * _frequency / 1000; // PWM periods available for fade
+  _lastShow = now;
+  #endif
 
   [[maybe_unused]] unsigned hPoint = 0;  // phase shift (0 - maxBri)
   // we will be phase shifting every channel by previous pulse length (plus dead time if required)
@@ -609,9 +648,30 @@ void BusPwm::show() {
     unsigned ch = channel%8;  // group channel
     // directly write to LEDC struct as there is no HAL exposed function for dithering
     // duty has 20 bit resolution with 4 fractional bits (24 bits in total)
-    LEDC.channel_group[gr].channel[ch].duty.duty = duty << ((!dithering)*4);  // lowest 4 bits are used for dithering, shift by 4 bits if not using dithering
+    uint32_t target = duty << ((!dithering)*4);  // lowest 4 bits are used for dithering, shift by 4 bits if not using dithering
+    uint32_t start  = target;
+    // fade increments apply to the integer part of duty (duty_scale is not shifted by the 4 fractional bits)
+    const unsigned targetInt = target >> 4;
+    const unsigned prevInt   = _duty[i] >> 4;
+    unsigned delta  = targetInt > prevInt ? targetInt - prevInt : prevInt - targetInt;
+    unsigned steps = 1, cycles = 1, scale = 0;
+    // no fading with dead time (H-bridge): intermediate duties of both channels could overlap
+    if (deadTime == 0 && delta > 0 && periods > 1) {
+      steps  = min(min(delta, periods), 1023U);         // number of duty increments
+      scale  = min(delta / steps, 1023U);               // integer duty increment per step
+      cycles = min(max(periods / steps, 1U), 1023U);    // PWM periods per step
+      // start where the ramp ends exactly at target (remainder of division is applied immediately)
+      // fractional bits of target are kept in start, increments do not change them
+      start  = targetInt > prevInt ? target - ((scale * steps) << 4) : target + ((scale * steps) << 4);
+    }
+    _duty[i] = target;
+    LEDC.channel_group[gr].channel[ch].duty.duty = start;
+    LEDC.channel_group[gr].channel[ch].conf1.duty_inc   = target >= start;
+    LEDC.channel_group[gr].channel[ch].conf1.duty_num   = steps;
+    LEDC.channel_group[gr].channel[ch].conf1.duty_cycle = cycles;
+    LEDC.channel_group[gr].channel[ch].conf1.duty_scale = scale;
     LEDC.channel_group[gr].channel[ch].hpoint.hpoint = hPoint >> bitShift;    // hPoint is at _depth resolution (needs shifting if dithering)
-    ledc_update_duty((ledc_mode_t)gr, (ledc_channel_t)ch);
+    ledc_update_duty((ledc_mode_t)gr, (ledc_channel_t)ch); // also starts the fade
     hPoint += duty + deadTime;        // offset to cascade the signals
     if (hPoint >= maxBri) hPoint = 0; // offset it out of bounds, reset
     #endif
@@ -710,6 +770,8 @@ std::vector<LEDType> BusOnOff::getLEDTypes() {
 BusNetwork::BusNetwork(BusConfig &bc)
 : Bus(bc.type, bc.start, bc.autoWhite, bc.count)
 , _broadcastLock(false)
+, _changed(true)
+, _lastShow(0)
 {
   switch (bc.type) {
     case TYPE_NET_ARTNET_RGB:
@@ -739,10 +801,12 @@ void BusNetwork::setPixelColor(uint16_t pix, uint32_t c) {
   if (_hasWhite) c = autoWhiteCalc(c);
   if (Bus::_cct >= 1900) c = colorBalanceFromKelvin(Bus::_cct, c); //color correction from CCT
   unsigned offset = pix * _UDPchannels;
+  uint8_t diff = (_data[offset] ^ R(c)) | (_data[offset+1] ^ G(c)) | (_data[offset+2] ^ B(c));
   _data[offset]   = R(c);
   _data[offset+1] = G(c);
   _data[offset+2] = B(c);
-  if (_hasWhite) _data[offset+3] = W(c);
+  if (_hasWhite) { diff |= _data[offset+3] ^ W(c); _data[offset+3] = W(c); }
+  if (diff) _changed = true;
 }
 
 uint32_t BusNetwork::getPixelColor(uint16_t pix) const {
@@ -753,6 +817,11 @@ uint32_t BusNetwork::getPixelColor(uint16_t pix) const {
 
 void BusNetwork::show() {
   if (!_valid || !canShow()) return;
+  // skip re-sending an identical frame (e.g. partial realtime update that did not touch this bus) until keep-alive elapses
+  unsigned long now = millis();
+  if (!_changed && _keepAlive && now - _lastShow < _keepAlive) return;
+  _changed = false;
+  _lastShow = now;
   _broadcastLock = true;
   realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, hasWhite());
   _broadcastLock = false;
@@ -811,6 +880,21 @@ uint32_t BusManager::memUsage(unsigned maxChannels, unsigned maxCount, unsigned
   return (maxChannels * maxCount * minBuses * multiplier);
 }
 
+uint32_t BusManager::maxMemory() {
+#ifdef WLED_LARGE_INSTALL
+  // output buffers need internal RAM, use what is available apart from a reserve for the rest of the system
+  // measured while no outputs exist, afterwards the last value is reported (settings page)
+  static uint32_t maxMem = MAX_LED_MEMORY;
+  if (numBusses == 0) {
+    size_t avail = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    maxMem = avail > MAX_LED_MEMORY + LED_MEMORY_RESERVE ? avail - LED_MEMORY_RESERVE : MAX_LED_MEMORY;
+  }
+  return maxMem;
+#else
+  return MAX_LED_MEMORY;
+#endif
+}
+
 int BusManager::add(BusConfig &bc) {
   if (getNumBusses() - getNumVirtualBusses() >= WLED_MAX_BUSSES) return -1;
   if (Bus::isVirtual(bc.type)) {
@@ -1009,6 +1093,10 @@ bool PolyBus::useParallelI2S = false;
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
 uint8_t Bus::_gAWM = 255;
+uint16_t Bus::_keepAlive = 1000;
+uint16_t Bus::_briSrc = 0;
+bool     Bus::_briSrcGamma = false;
+uint8_t  Bus::_briSrcOut = 0;
 
 uint16_t BusDigital::_milliAmpsTotal = 0;
 
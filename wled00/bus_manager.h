@@ -150,6 +150,11 @@ class Bus {
     static inline void     setGlobalAWMode(uint8_t m) { if (m < 5) _gAWM = m; else _gAWM = AW_GLOBAL_DISABLED; }
     static inline uint8_t  getGlobalAWMode()          { return _gAWM; }
     static inline void     setCCT(int16_t cct)        { _cct = cct; }
+    static inline uint16_t getKeepAlive()             { return _keepAlive; }
+    static inline void     setKeepAlive(uint16_t ms)  { _keepAlive = ms; }
+    // uncorrected (8.8 fixed point) brightness that produced bus brightness out, so high resolution outputs can
+    // apply perceptual correction only once and at full precision; gamma: out was produced using gamma table
+    static inline void     setBrightnessSource(uint16_t src, bool gamma, uint8_t out) { _briSrc = src; _briSrcGamma = gamma; _briSrcOut = out; }
     static inline uint8_t  getCCTBlend()              { return _cctBlend; }
     static inline void setCCTBlend(uint8_t b) {
       _cctBlend = (std::min((int)b,100) * 127) / 100;
@@ -187,10 +192,15 @@ class Bus {
     //   63 - semi additive/nonlinear (CCT 127 => 66% warm, 66% cold)
     //  127 - additive CCT blending (CCT 127 => 100% warm, 100% cold)
     static uint8_t _cctBlend;
+    // unchanged frames are not sent to LEDs more often than every _keepAlive ms (0 = always send)
+    static uint16_t _keepAlive;
+    static uint16_t _briSrc;
+    static bool     _briSrcGamma;
+    static uint8_t  _briSrcOut;
 
     uint32_t autoWhiteCalc(uint32_t c) const;
     uint8_t *allocateData(size_t size = 1);
-    void     freeData() { if (_data != nullptr) free(_data); _data = nullptr; }
+    void     freeData();
 };
 
 
@@ -228,6 +238,9 @@ class BusDigital : public Bus {
     uint16_t _milliAmpsMax;
     void * _busPtr;
     const ColorOrderMap &_colorOrderMap;
+    bool _changed;                  // pixel data or brightness changed since last show()
+    uint16_t _milliAmpsLast;        // current estimate of last frame sent (reused if frame is skipped)
+    unsigned long _lastShow;        // millis() of last frame sent
 
     static uint16_t _milliAmpsTotal; // is overwitten/recalculated on each show()
 
@@ -265,6 +278,8 @@ class BusPwm : public Bus {
     uint8_t _pwmdata[OUTPUT_MAX_PINS];
     #ifdef ARDUINO_ARCH_ESP32
     uint8_t _ledcStart;
+    uint32_t _duty[OUTPUT_MAX_PINS]; // last duty target written to LEDC (incl. 4 fractional bits)
+    unsigned long _lastShow;
     #endif
     uint8_t _depth;
     uint16_t _frequency;
@@ -298,6 +313,7 @@ class BusNetwork : public Bus {
     ~BusNetwork() { cleanup(); }
 
     bool canShow() const override  { return !_broadcastLock; } // this should be a return value from UDP routine if it is still sending data out
+    void setBrightness(uint8_t b) override { if (_bri != b) _changed = true; Bus::setBrightness(b); }
     void setPixelColor(uint16_t pix, uint32_t c) override;
     uint32_t getPixelColor(uint16_t pix) const override;
     uint8_t  getPins(uint8_t* pinArray = nullptr) const override;
@@ -311,6 +327,8 @@ class BusNetwork : public Bus {
     uint8_t   _UDPtype;
     uint8_t   _UDPchannels;
     bool      _broadcastLock;
+    bool      _changed;   // pixel data or brightness changed since last show()
+    unsigned long _lastShow;
 };
 
 
@@ -369,6 +387,7 @@ class BusManager {
     //utility to get the approx. memory usage of a given BusConfig
     static uint32_t memUsage(BusConfig &bc);
     static uint32_t memUsage(unsigned channels, unsigned count, unsigned buses = 1);
+    static uint32_t maxMemory(); // memory all outputs may use (call before adding buses)
     static uint16_t currentMilliamps() { return _milliAmpsUsed; }
     static uint16_t ablMilliampsMax()  { return _milliAmpsMax; }
 
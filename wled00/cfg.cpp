@@ -117,6 +117,8 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(strip.cctBlending, hw_led[F("cb")]);
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
+  strip.setFrameBudget(hw_led[F("fb")] | strip.getFrameBudget()); // 0 = use frame time
+  Bus::setKeepAlive(hw_led[F("ka")] | Bus::getKeepAlive()); // 0 = send every frame
   CJSON(useGlobalLedBuffer, hw_led[F("ld")]);
 
   #ifndef WLED_DISABLE_2D
@@ -191,6 +193,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     }
     #endif
 
+    const unsigned maxMem = BusManager::maxMemory();
     for (JsonObject elm : ins) {
       if (s >= WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES) break;
       uint8_t pins[5] = {255, 255, 255, 255, 255};
@@ -228,7 +231,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
           if (memT > mem) mem = memT; // if we have unequal LED count use the largest
         } else
           mem += BusManager::memUsage(bc); // includes global buffer
-        if (mem <= MAX_LED_MEMORY) if (BusManager::add(bc) == -1) break;  // finalization will be done in WLED::beginStrip()
+        if (mem <= maxMem) if (BusManager::add(bc) == -1) break;  // finalization will be done in WLED::beginStrip()
       } else {
         if (busConfigs[s] != nullptr) delete busConfigs[s];
         busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst, AWmode, freqkHz, useGlobalLedBuffer, maPerLed, maMax);
@@ -822,6 +825,8 @@ void serializeConfig() {
   hw_led[F("ic")] = cctICused;
   hw_led[F("cb")] = strip.cctBlending;
   hw_led["fps"] = strip.getTargetFps();
+  hw_led[F("fb")] = strip.getFrameBudget();
+  hw_led[F("ka")] = Bus::getKeepAlive();
   hw_led[F("rgbwm")] = Bus::getGlobalAWMode(); // global auto white mode override
   hw_led[F("ld")] = useGlobalLedBuffer;
 
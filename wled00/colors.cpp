@@ -471,14 +471,66 @@ uint8_t NeoGammaWLEDMethod::gammaT[256] = {
   177,180,182,184,186,189,191,193,196,198,200,203,205,208,210,213,
   215,218,220,223,225,228,231,233,236,239,241,244,247,249,252,255 };
 
+//gamma 2.8 lookup table with 16 bit output, used for brightness of high resolution (PWM) outputs
+uint16_t NeoGammaWLEDMethod::gammaT16[256] = {
+      0,    0,    0,    0,    1,    1,    2,    3,    4,    6,    8,   10,   13,   16,   19,   24,
+     28,   33,   39,   46,   53,   60,   69,   78,   88,   98,  110,  122,  135,  149,  164,  179,
+    196,  214,  232,  252,  273,  295,  317,  341,  366,  393,  420,  449,  478,  510,  542,  575,
+    610,  647,  684,  723,  764,  806,  849,  894,  940,  988, 1037, 1088, 1140, 1194, 1250, 1307,
+   1366, 1427, 1489, 1553, 1619, 1686, 1756, 1827, 1900, 1975, 2051, 2130, 2210, 2293, 2377, 2463,
+   2552, 2642, 2734, 2829, 2925, 3024, 3124, 3227, 3332, 3439, 3548, 3660, 3774, 3890, 4008, 4128,
+   4251, 4376, 4504, 4634, 4766, 4901, 5038, 5177, 5319, 5464, 5611, 5760, 5912, 6067, 6224, 6384,
+   6546, 6711, 6879, 7049, 7222, 7397, 7576, 7757, 7941, 8128, 8317, 8509, 8704, 8902, 9103, 9307,
+   9514, 9723, 9936,10151,10370,10591,10816,11043,11274,11507,11744,11984,12227,12473,12722,12975,
+  13230,13489,13751,14017,14285,14557,14833,15111,15393,15678,15967,16259,16554,16853,17155,17461,
+  17770,18083,18399,18719,19042,19369,19700,20034,20372,20713,21058,21407,21759,22115,22475,22838,
+  23206,23577,23952,24330,24713,25099,25489,25884,26282,26683,27089,27499,27913,28330,28752,29178,
+  29608,30041,30479,30921,31367,31818,32272,32730,33193,33660,34131,34606,35085,35569,36057,36549,
+  37046,37547,38052,38561,39075,39593,40116,40643,41175,41711,42251,42796,43346,43899,44458,45021,
+  45588,46161,46737,47319,47905,48495,49091,49691,50295,50905,51519,52138,52761,53390,54023,54661,
+  55303,55951,56604,57261,57923,58590,59262,59939,60621,61308,62000,62697,63399,64106,64818,65535 };
+
+//CIE 1931 lightness to luminance (16 bit) lookup table, used for perceptual brightness of PWM outputs
+static const uint16_t cieT16[256] PROGMEM = {
+      0,   28,   57,   85,  114,  142,  171,  199,  228,  256,  285,  313,  341,  370,  398,  427,
+    455,  484,  512,  541,  569,  598,  627,  658,  689,  721,  755,  789,  825,  861,  899,  937,
+    977, 1018, 1060, 1103, 1147, 1192, 1239, 1287, 1336, 1386, 1437, 1490, 1544, 1599, 1656, 1714,
+   1773, 1834, 1896, 1959, 2024, 2090, 2157, 2226, 2297, 2369, 2442, 2517, 2593, 2671, 2751, 2832,
+   2914, 2999, 3085, 3172, 3261, 3352, 3444, 3538, 3634, 3732, 3831, 3932, 4035, 4139, 4245, 4354,
+   4464, 4575, 4689, 4804, 4922, 5041, 5162, 5285, 5410, 5537, 5666, 5797, 5930, 6065, 6202, 6341,
+   6482, 6626, 6771, 6918, 7068, 7220, 7373, 7529, 7687, 7848, 8010, 8175, 8342, 8512, 8683, 8857,
+   9033, 9212, 9393, 9576, 9762, 9949,10140,10333,10528,10725,10926,11128,11333,11541,11751,11963,
+  12179,12396,12617,12840,13065,13293,13524,13757,13993,14232,14474,14718,14965,15215,15467,15722,
+  15980,16241,16505,16771,17041,17313,17588,17866,18147,18431,18717,19007,19300,19596,19894,20196,
+  20501,20809,21119,21433,21750,22071,22394,22720,23050,23383,23719,24058,24400,24746,25095,25447,
+  25802,26161,26523,26888,27257,27629,28004,28383,28765,29151,29540,29932,30328,30728,31131,31537,
+  31947,32360,32777,33198,33622,34050,34481,34916,35355,35797,36243,36693,37146,37603,38064,38529,
+  38997,39469,39945,40425,40908,41396,41887,42382,42881,43384,43891,44401,44916,45435,45957,46484,
+  47015,47549,48088,48631,49178,49728,50283,50843,51406,51973,52545,53120,53700,54284,54873,55465,
+  56062,56663,57269,57878,58492,59111,59733,60360,60992,61627,62268,62912,63561,64215,64873,65535 };
+
 // re-calculates & fills gamma table
 void NeoGammaWLEDMethod::calcGammaTable(float gamma)
 {
   for (size_t i = 0; i < 256; i++) {
-    gammaT[i] = (int)(powf((float)i / 255.0f, gamma) * 255.0f + 0.5f);
+    float g = powf((float)i / 255.0f, gamma);
+    gammaT[i]   = (int)(g * 255.0f + 0.5f);
+    gammaT16[i] = (int)(g * 65535.0f + 0.5f);
   }
 }
 
+// converts 8.8 fixed point perceptual brightness into 16 bit luminance (0-65535)
+// using the gamma curve (if brightness gamma correction is used) or CIE lightness curve
+// values between table entries are linearly interpolated to retain low-end precision
+uint16_t perceptualToLinear16(uint16_t v, bool gamma)
+{
+  unsigned hi = v >> 8, lo = v & 0xFF;
+  unsigned a = gamma ? NeoGammaWLEDMethod::rawGamma16(hi) : pgm_read_word(&cieT16[hi]);
+  if (lo == 0 || hi == 255) return a;
+  unsigned b = gamma ? NeoGammaWLEDMethod::rawGamma16(hi+1) : pgm_read_word(&cieT16[hi+1]);
+  return a + (((b - a) * lo) >> 8);
+}
+
 uint8_t IRAM_ATTR_YN NeoGammaWLEDMethod::Correct(uint8_t value)
 {
   if (!gammaCorrectCol) return value;
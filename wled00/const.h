@@ -44,6 +44,14 @@
   #endif
 #endif
 
+#ifndef WLED_MAX_STATE_SLOTS
+  #ifdef ESP8266
+    #define WLED_MAX_STATE_SLOTS 2
+  #else
+    #define WLED_MAX_STATE_SLOTS 8
+  #endif
+#endif
+
 #ifndef WLED_MAX_BUSSES
   #ifdef ESP8266
     #define WLED_MAX_DIGITAL_CHANNELS 3
@@ -147,6 +155,14 @@
   #endif
 #endif
 
+#ifndef WLED_MAX_DRAW_POINTS
+  #ifdef ESP8266
+    #define WLED_MAX_DRAW_POINTS 32   // max number of polygon/polyline points in JSON "draw" command
+  #else
+    #define WLED_MAX_DRAW_POINTS 64
+  #endif
+#endif
+
 //Usermod IDs
 #define USERMOD_ID_RESERVED               0     //Unused. Might indicate no usermod present
 #define USERMOD_ID_UNSPECIFIED            1     //Default value for a general user mod that does not specify a custom ID
@@ -416,6 +432,13 @@
 #define PL_OPTION_SHUFFLE      0x01
 #define PL_OPTION_RESTORE      0x02
 
+// Binary pixel upload formats (applyPixelData())
+#define PIXEL_FMT_RGB          0
+#define PIXEL_FMT_RGBW         1
+#define PIXEL_FMT_RGB565       2
+#define PIXEL_FMT_PAL          3
+#define PIXEL_FMT_RLE       0x80 // flag: payload is run length encoded
+
 // Segment capability byte
 #define SEG_CAPABILITY_RGB     0x01
 #define SEG_CAPABILITY_W       0x02
@@ -445,6 +468,8 @@
 #define NL_MODE_COLORFADE         2            //Fade to target brightness and secondary color gradually
 #define NL_MODE_SUN               3            //Sunrise/sunset. Target brightness is set immediately, then Sunrise effect is started. Max 60 min.
 
+#define NL_FADE_MILESTONES       16            //number of interface updates sent during nightlight fade
+
 // Settings sub page IDs
 #define SUBPAGE_MENU              0
 #define SUBPAGE_WIFI              1
@@ -469,6 +494,21 @@
 // Maximum number of pins per output. 5 for RGBCCT analog LEDs.
 #define OUTPUT_MAX_PINS 5
 
+// large installation mode (ESP32, ideally with PSRAM): raises LED and universe limits, output memory is
+// limited by free RAM at boot instead of MAX_LED_MEMORY and mapping tables are placed in PSRAM
+#ifdef WLED_LARGE_INSTALL
+  #ifdef ESP8266
+    #error "WLED_LARGE_INSTALL is not supported on ESP8266."
+  #endif
+  #ifndef MAX_LEDS
+    #define MAX_LEDS 32768
+  #endif
+  #ifndef MAX_LEDS_PER_BUS
+    #define MAX_LEDS_PER_BUS 8192
+  #endif
+  #define LED_MEMORY_RESERVE (64*1024) // internal RAM left to WiFi, web server & effects when sizing outputs
+#endif
+
 //maximum number of rendered LEDs - this does not have to match max. physical LEDs, e.g. if there are virtual busses
 #ifndef MAX_LEDS
 #ifdef ESP8266
@@ -477,6 +517,9 @@
 #define MAX_LEDS 8192
 #endif
 #endif
+#if MAX_LEDS > 65535
+  #error "MAX_LEDS must not exceed 65535 (16 bit pixel indices)."
+#endif
 
 #ifndef MAX_LED_MEMORY
   #ifdef ESP8266
@@ -501,7 +544,15 @@
 #define SETTINGS_STACK_BUF_SIZE 3840  // warning: quite a large value for stack (640 * WLED_MAX_USERMODS)
 #endif
 
-#ifdef WLED_USE_ETHERNET
+#define MAX_3_CH_LEDS_PER_UNIVERSE 170
+#define MAX_4_CH_LEDS_PER_UNIVERSE 128
+#define MAX_CHANNELS_PER_UNIVERSE 512
+
+#if defined(WLED_LARGE_INSTALL)
+  // enough 3 channel universes for MAX_LEDS, ESPAsyncE131 counts universes in 8 bits
+  #define E131_UNIVERSES_FOR_MAX_LEDS ((MAX_LEDS + MAX_3_CH_LEDS_PER_UNIVERSE - 1) / MAX_3_CH_LEDS_PER_UNIVERSE + 1)
+  #define E131_MAX_UNIVERSE_COUNT (E131_UNIVERSES_FOR_MAX_LEDS < 255 ? E131_UNIVERSES_FOR_MAX_LEDS : 255)
+#elif defined(WLED_USE_ETHERNET)
   #define E131_MAX_UNIVERSE_COUNT 20
 #else
   #ifdef ESP8266
@@ -543,6 +594,13 @@
   #endif
 #endif
 #endif
+#ifndef PWM_FADE_MAX_MS
+  #define PWM_FADE_MAX_MS 50      // longest hardware ramp between two frames (ESP32)
+#endif
+
+#ifndef REALTIME_SHOW_INTERVAL
+  #define REALTIME_SHOW_INTERVAL 15 // min ms between LED updates from realtime packets (updates in between are coalesced)
+#endif
 
 #define TOUCH_THRESHOLD 32 // limit to recognize a touch, higher value means more sensitive
 
@@ -556,10 +614,45 @@
     #define JSON_BUFFER_SIZE 32767
   #endif
 #endif
+// state JSON streams segments one at a time (see printStateJson()), each through a document of this size
+#define JSON_SEGMENT_SIZE 1536
 
 //#define MIN_HEAP_SIZE (8k for AsyncWebServer)
 #define MIN_HEAP_SIZE 8192
 
+// memory placement tiers (see allocMem() in util.cpp)
+#define MEM_HOT              0  // internal RAM: data touched for every pixel/frame or by ISR/DMA, PSRAM only as last resort
+#define MEM_BULK             1  // PSRAM if available: large or rarely accessed data, internal RAM as fallback
+#define MEM_AUTO             2  // MEM_BULK for blocks of PSRAM_THRESHOLD bytes or more, MEM_HOT otherwise
+#ifdef WLED_LARGE_INSTALL
+  #define MEM_MAP            MEM_BULK // ledmap & 2D lookup tables (2 bytes per LED) would exhaust internal RAM
+#else
+  #define MEM_MAP            MEM_HOT
+#endif
+#ifndef PSRAM_THRESHOLD
+  #define PSRAM_THRESHOLD 1024
+#endif
+// hot data is placed in PSRAM if internal RAM would drop below this (keeps room for WiFi & TCP)
+#define MEM_INTERNAL_RESERVE (4*MIN_HEAP_SIZE)
+
+// memory owners (for usage accounting)
+#define MEM_OWNER_SEGMENT    0  // effect data
+#define MEM_OWNER_TRANSITION 1  // copy of effect data during transition
+#define MEM_OWNER_LEDMAP     2
+#define MEM_OWNER_PIXELMAP   3  // 2D coordinate lookup tables
+#define MEM_OWNER_PALETTE    4
+#define MEM_OWNER_BUS        5  // bus double buffers
+#define MEM_OWNER_JSON       6  // rendered state JSON text
+#define MEM_OWNERS           7
+
+// main loop scheduler (see scheduler.cpp)
+#define TASK_PRIO_LOW        0  // runs only in the slack before the next LED frame is due
+#define TASK_PRIO_HIGH       1  // runs whenever it is due
+#ifndef WLED_MAX_TASKS
+  #define WLED_MAX_TASKS    12
+#endif
+#define TASK_STARVATION_MS 250  // low priority task deferred longer than this (or 4 periods) runs anyway
+
 // Maximum size of node map (list of other WLED instances)
 #ifdef ESP8266
   #define WLED_MAX_NODES 24
@@ -2774,14 +2774,24 @@ function loadPalettesData(callback = null)
 	}
 
 	palettesData = {};
-	getPalettesData(0, ()=>{
+	let done = ()=>{
 		localStorage.setItem(lsKey, JSON.stringify({
 			p: palettesData,
 			vid: lastinfo.vid
 		}));
 		redrawPalPrev();
 		if (callback) setTimeout(callback, 99);
-	});
+	};
+	// built-in palettes are static (cached by browser), only custom palettes need to be fetched from state
+	fetch(getURL('/palettes.json'), {
+		method: 'get'
+	})
+	.then(res => res.ok ? res.json() : Promise.reject())
+	.then(json => {
+		palettesData = json.p;
+		getPalettesData(-1, done);
+	})
+	.catch(() => getPalettesData(0, done)); // older firmware
 }
 
 function getPalettesData(page, callback)
@@ -2796,7 +2806,7 @@ function getPalettesData(page, callback)
 	.then(json => {
 		retry = false;
 		palettesData = Object.assign({}, palettesData, json.p);
-		if (page < json.m) setTimeout(()=>{ getPalettesData(page + 1, callback); }, 75);
+		if (page >= 0 && page < json.m) setTimeout(()=>{ getPalettesData(page + 1, callback); }, 75);
 		else callback();
 	})
 	.catch((error)=>{
@@ -1,9 +1,5 @@
 #include "wled.h"
 
-#define MAX_3_CH_LEDS_PER_UNIVERSE 170
-#define MAX_4_CH_LEDS_PER_UNIVERSE 128
-#define MAX_CHANNELS_PER_UNIVERSE 512
-
 /*
  * E1.31 handler
  */
@@ -29,12 +25,17 @@ void handleDDPPacket(e131_packet_t* p) {
   unsigned ddpChannelsPerLed = ((p->dataType & 0b00111000)>>3 == 0b011) ? 4 : 3; // data type 0x1B (formerly 0x1A) is RGBW (type 3, 8 bit/channel)
 
   uint32_t start =  htonl(p->channelOffset) / ddpChannelsPerLed;
-  start += DMXAddress / ddpChannelsPerLed;
-  unsigned stop = start + htons(p->dataLen) / ddpChannelsPerLed;
+  unsigned count = htons(p->dataLen) / ddpChannelsPerLed;
   uint8_t* data = p->data;
   unsigned c = 0;
   if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
 
+  // pixels bound to segments do not lock the strip (drawn by strip.service())
+  if (setSegmentRealtimePixels(REALTIME_MODE_DDP, start, data + c, count, ddpChannelsPerLed)) return;
+
+  start += DMXAddress / ddpChannelsPerLed;
+  unsigned stop = start + count;
+
   if (realtimeMode != REALTIME_MODE_DDP) ddpSeenPush = false; // just starting, no push yet
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
 
@@ -101,6 +102,13 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   }
   #endif
 
+  // universes bound to segments do not lock the strip (DMX data in Art-Net packet starts at index 0, for E1.31 at index 1)
+  // (sequence numbers of bound universes are tracked per segment)
+  if (setSegmentRealtimePixels(mde, uni * MAX_3_CH_LEDS_PER_UNIVERSE, e131_data + (protocol == P_ARTNET ? 0 : 1), dmxChannels / 3, 3, e131SkipOutOfSequence ? seq : -1)) {
+    realtimeIP = clientIP;
+    return; // drawn by strip.service()
+  }
+
   // only listen for universes we're handling & allocated memory
   if (uni < e131Universe || uni >= (e131Universe + E131_MAX_UNIVERSE_COUNT)) return;
 
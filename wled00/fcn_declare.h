@@ -73,9 +73,12 @@ class NeoGammaWLEDMethod {
     [[gnu::hot]] static uint32_t Correct32(uint32_t color);     // apply Gamma to RGBW32 color (WLED specific, not used by NPB)
     static void calcGammaTable(float gamma);                              // re-calculates & fills gamma table
     static inline uint8_t rawGamma8(uint8_t val) { return gammaT[val]; }  // get value from Gamma table (WLED specific, not used by NPB)
+    static inline uint16_t rawGamma16(uint8_t val) { return gammaT16[val]; } // get 16 bit value from Gamma table (for high resolution outputs)
   private:
     static uint8_t gammaT[];
+    static uint16_t gammaT16[];
 };
+uint16_t perceptualToLinear16(uint16_t v, bool gamma);
 #define gamma32(c) NeoGammaWLEDMethod::Correct32(c)
 #define gamma8(c)  NeoGammaWLEDMethod::rawGamma8(c)
 [[gnu::hot]] uint32_t color_blend(uint32_t,uint32_t,uint16_t,bool b16=false);
@@ -147,6 +150,12 @@ void initIR();
 void deInitIR();
 void handleIR();
 
+//util.cpp (memory placement, declared ahead of FX.h which uses it)
+void *allocMem(size_t size, uint8_t tier, uint8_t owner); // returns zeroed block
+void  freeMem(void *ptr);
+bool  isPSRAM(const void *ptr);
+size_t getMemUsage(uint8_t owner, bool psram);
+
 //json.cpp
 #include "ESPAsyncWebServer.h"
 #include "src/dependencies/json/ArduinoJson-v6.h"
@@ -155,8 +164,12 @@ void handleIR();
 
 bool deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
+bool applyPixelData(const uint8_t *data, size_t len);
 void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
 void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool selectedSegmentsOnly = false);
+size_t printStateJson(JsonDocument &doc, Print &dest); // output of non-preset state has to be printed with these
+size_t measureStateJson(JsonDocument &doc);
+size_t serializeStateJson(JsonDocument &doc, char *buf, size_t len);
 void serializeInfo(JsonObject root);
 void serializeModeNames(JsonArray root);
 void serializeModeData(JsonArray root);
@@ -196,6 +209,14 @@ void handleNetworkTime();
 void sendNTPPacket();
 bool checkNTPResponse();
 void updateLocalTime();
+uint8_t  localHour();
+uint8_t  localMinute();
+uint8_t  localSecond();
+uint8_t  localWeekday();
+uint8_t  localDay();
+uint8_t  localMonth();
+uint16_t localYear();
+uint16_t localMillis();
 void getTimeString(char* out);
 bool checkCountdown();
 void setCountdown();
@@ -204,6 +225,13 @@ void checkTimers();
 void calculateSunriseAndSunset();
 void setTimeFromAPI(uint32_t timein);
 
+//ota_update.cpp
+bool otaBegin(const char *sha256 = nullptr);
+bool otaWrite(const uint8_t *data, size_t len);
+bool otaEnd();
+void otaAbort();
+void handleOTA();
+
 //overlay.cpp
 void handleOverlayDraw();
 void _overlayAnalogCountdown();
@@ -228,10 +256,31 @@ void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = Js
 inline void saveTemporaryPreset() {savePreset(255);};
 void deletePreset(byte index);
 bool getPresetName(byte index, String& name);
+bool saveStateSlot(byte slot);
+bool recallStateSlot(byte slot, byte callMode = CALL_MODE_DIRECT_CHANGE);
 
 //remote.cpp
 void handleRemote(uint8_t *data, size_t len);
 
+//scheduler.cpp
+typedef void (*task_fn_t)();
+typedef struct SchedulerTask {
+  const char *name;
+  task_fn_t   fn;
+  uint16_t    period;   // ms between runs (0 = every loop)
+  uint8_t     priority; // TASK_PRIO_LOW or TASK_PRIO_HIGH
+  uint32_t    lastRun;  // millis() of last run
+  uint32_t    cost;     // estimated run time in us (running average of measured time)
+  uint32_t    maxCost;  // longest measured run time in us
+  uint32_t    runs;
+  uint32_t    deferred; // number of times task was due but postponed for lack of slack
+} sched_task_t;
+bool addTask(const char *name, task_fn_t fn, uint16_t period, uint8_t priority = TASK_PRIO_LOW, uint16_t estCost = 1000);
+void handleTasks();
+unsigned getFrameSlack();
+uint8_t getTaskCount();
+const sched_task_t *getTask(uint8_t i);
+
 //set.cpp
 bool isAsterisksOnly(const char* str, byte maxLen);
 void handleSettingsSet(AsyncWebServerRequest *request, byte subPage);
@@ -244,6 +293,7 @@ void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+bool setSegmentRealtimePixels(byte proto, unsigned first, const uint8_t *data, unsigned count, unsigned channels, int seq = -1);
 void refreshNodeList();
 void sendSysInfoUDP();
 #ifndef WLED_DISABLE_ESPNOW
@@ -1,6 +1,7 @@
 #include "wled.h"
 
 #include "palettes.h"
+#include <memory>
 
 #define JSON_PATH_STATE      1
 #define JSON_PATH_INFO       2
@@ -11,10 +12,30 @@
 #define JSON_PATH_NETWORKS   7
 #define JSON_PATH_EFFECTS    8
 
+// placeholder for the segment array in state JSON, expanded by printStateJson() (control characters in strings are escaped)
+#define JSON_SEG_MARK        '\x01'
+static const char segStreamMark[] = { JSON_SEG_MARK, 0 };
+
 /*
  * JSON API (De)serialization
  */
 
+#ifndef WLED_DISABLE_2D
+// color for draw commands: [r,g,b,w] array or hex string, gamma corrected like "i"
+static uint32_t jsonColor(JsonVariant v)
+{
+  uint8_t rgbw[] = {0,0,0,0};
+  JsonArray arr = v;
+  if (!arr.isNull()) {
+    size_t sz = arr.size();
+    if (sz > 0 && sz < 5) copyArray(arr, rgbw);
+  } else if (v.is<const char*>()) {
+    colorFromHexString(rgbw, v.as<const char*>());
+  }
+  return gamma32(RGBW32(rgbw[0], rgbw[1], rgbw[2], rgbw[3]));
+}
+#endif
+
 bool deserializeSegment(JsonObject elem, byte it, byte presetId)
 {
   byte id = elem["id"] | it;
@@ -65,14 +86,16 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     return true;
   }
 
-  if (elem["n"]) {
+  const char * name = elem["n"].as<const char*>();
+  if (elem["n"] && seg.name && name && strncmp(seg.name, name, WLED_MAX_SEGNAME_LEN) == 0) {
+    // name field exists but is unchanged
+  } else if (elem["n"]) {
     // name field exists
     if (seg.name) { //clear old name
       delete[] seg.name;
       seg.name = nullptr;
     }
 
-    const char * name = elem["n"].as<const char*>();
     size_t len = 0;
     if (name != nullptr) len = strlen(name);
     if (len > 0) {
@@ -105,6 +128,15 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
   uint8_t set = elem[F("set")] | seg.set;
   seg.set = constrain(set, 0, 3);
 
+  seg.fps = elem["fps"] | seg.fps;
+  uint8_t prio = elem[F("prio")] | seg.priority;
+  seg.priority = constrain(prio, 0, SEG_PRIORITY_MAX);
+  // realtime binding: segment shows data of its own universes/pixels, other segments keep running effects
+  uint8_t rtp = elem[F("rtp")] | seg.rtProto;
+  seg.rtProto = (rtp == REALTIME_MODE_UDP || rtp == REALTIME_MODE_E131 || rtp == REALTIME_MODE_ARTNET || rtp == REALTIME_MODE_DDP) ? rtp : REALTIME_MODE_INACTIVE;
+  seg.rtStart   = elem[F("rtu")] | seg.rtStart;
+  seg.rtTimeout = elem[F("rtt")] | seg.rtTimeout;
+
   int len = 1;
   if (stop > start) len = stop - start;
   int offset = elem[F("of")] | INT32_MAX;
@@ -184,7 +216,9 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
 
         if (!colValid) continue;
 
-        seg.setColor(i, RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]));
+        uint32_t color = RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
+        if (color == seg.colors[i]) continue; // unchanged, do not refresh
+        seg.setColor(i, color);
         if (seg.mode == FX_MODE_STATIC) strip.trigger(); //instant refresh
       }
     } else {
@@ -311,12 +345,137 @@ bool deserializeSegment(JsonObject elem, byte it, byte presetId)
     seg.map1D2D = oldMap1D2D; // restore mapping
     strip.trigger(); // force segment update
   }
+
+  #ifndef WLED_DISABLE_2D
+  // vector draw commands (2D segments), coordinates are in (fractional) virtual pixels
+  // "draw":[["l",x0,y0,x1,y1,width,col], ["pl",[x0,y0,x1,y1,...],width,col], ["p",[x0,y0,x1,y1,...],col],
+  //         ["a",cx,cy,r0,r1,deg0,deg1,col], ["g",x0,y0,x1,y1,col0,col1,radial]]
+  JsonArray darr = elem[F("draw")];
+  if (!darr.isNull() && seg.is2D()) {
+    // disable transition and freeze, same as "i"
+    jsonTransitionOnce = true;
+    seg.stopTransition();
+    strip.setTransition(0);
+    strip.setBrightness(scaledBri(bri), true);
+    if (!seg.freeze) {
+      seg.freeze = true;
+      seg.fill(BLACK);
+    }
+    for (JsonVariant v : darr) {
+      JsonArray cmd = v.as<JsonArray>();
+      const char *t = cmd[0];
+      if (!t) continue;
+      auto fx = [&](size_t i) { return int32_t(cmd[i].as<float>() * 256.0f); }; // to 24.8 fixed point
+      if (t[0] == 'l') {
+        seg.drawThickLine(fx(1), fx(2), fx(3), fx(4), max(fx(5), int32_t(1)), jsonColor(cmd[6]));
+      } else if (t[0] == 'p') {
+        JsonArray parr = cmd[1];
+        const bool line = (t[1] == 'l');
+        unsigned n = min(parr.size() / 2, size_t(WLED_MAX_DRAW_POINTS));
+        if (n < 2) continue;
+        int32_t pts[2*n];
+        for (size_t i = 0; i < 2*n; i++) pts[i] = int32_t(parr[i].as<float>() * 256.0f);
+        if (line) seg.drawPolyline(pts, n, max(fx(2), int32_t(1)), jsonColor(cmd[3]));
+        else      seg.fillPolygon(pts, n, jsonColor(cmd[2]));
+      } else if (t[0] == 'a') {
+        uint16_t a0 = uint16_t(int(cmd[5].as<float>() * 65536.0f / 360.0f));
+        uint16_t a1 = uint16_t(int(cmd[6].as<float>() * 65536.0f / 360.0f));
+        seg.drawArc(fx(1), fx(2), max(fx(3), int32_t(0)), max(fx(4), int32_t(0)), a0, a1, jsonColor(cmd[7]));
+      } else if (t[0] == 'g') {
+        seg.fillGradient(fx(1), fx(2), fx(3), fx(4), jsonColor(cmd[5]), jsonColor(cmd[6]), cmd[7] | false);
+      }
+    }
+    strip.trigger(); // force segment update
+  }
+  #endif
+
   // send UDP/WS if segment options changed (except selection; will also deselect current preset)
   if (seg.differs(prev) & 0x7F) stateChanged = true;
 
   return true;
 }
 
+/*
+ * Binary per-LED upload (WS binary message or HTTP POST /pixels, application/octet-stream)
+ * A faster alternative to the JSON "i" array that does not need the JSON buffer.
+ * byte 0:    'P' (magic)
+ * byte 1:    format (bits 0-2: 0=RGB, 1=RGBW, 2=RGB565 (big endian), 3=palette index), bit 7: RLE payload
+ * byte 2:    segment ID (255 = main segment)
+ * byte 3-4:  start offset within segment (big endian)
+ * byte 5-:   pixel data; with RLE each run is preceded by a run length byte (1-255)
+ */
+static inline size_t pixelFormatSize(uint8_t fmt) {
+  switch (fmt) {
+    case PIXEL_FMT_RGBW:   return 4;
+    case PIXEL_FMT_RGB565: return 2;
+    case PIXEL_FMT_PAL:    return 1;
+    default:               return 3;
+  }
+}
+
+bool applyPixelData(const uint8_t *data, size_t len)
+{
+  if (len < 5 || data[0] != 'P') return false;
+  const uint8_t fmt = data[1] & 0x07;
+  const bool    rle = data[1] & PIXEL_FMT_RLE;
+  if (fmt > PIXEL_FMT_PAL) return false;
+  const size_t  psz = pixelFormatSize(fmt);
+  const uint8_t id  = data[2] < strip.getSegmentsNum() ? data[2] : strip.getMainSegmentId();
+  unsigned pix = (data[3] << 8) | data[4];
+
+  Segment &seg = strip.getSegment(id);
+  if (!seg.isActive()) return false;
+  uint8_t oldMap1D2D = seg.map1D2D;
+  seg.map1D2D = M12_Pixels; // no mapping, same as JSON "i"
+
+  // set brightness immediately and disable transition
+  jsonTransitionOnce = true;
+  seg.stopTransition();
+  strip.setTransition(0);
+  strip.setBrightness(scaledBri(bri), true);
+
+  // freeze and init to black
+  if (!seg.freeze) {
+    seg.freeze = true;
+    seg.fill(BLACK);
+  }
+
+  CRGBPalette16 pal;
+  if (fmt == PIXEL_FMT_PAL) seg.loadPalette(pal, seg.palette);
+
+  const unsigned segLen = seg.virtualLength(); // with M12_Pixels this is width*height on 2D
+  size_t i = 5;
+  while (i < len && pix < segLen) {
+    unsigned run = 1;
+    if (rle) {
+      run = data[i++];
+      if (run == 0) break; // malformed
+    }
+    if (i + psz > len) break; // truncated pixel
+    const uint8_t *p = data + i;
+    uint32_t c;
+    switch (fmt) {
+      case PIXEL_FMT_RGBW:   c = RGBW32(p[0], p[1], p[2], p[3]); break;
+      case PIXEL_FMT_RGB565: {
+        uint16_t v = (p[0] << 8) | p[1];
+        uint8_t r = (v >> 11) & 0x1F, g = (v >> 5) & 0x3F, b = v & 0x1F;
+        c = RGBW32((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 0);
+      } break;
+      case PIXEL_FMT_PAL: {
+        CRGB fc = ColorFromPalette(pal, p[0], 255, (strip.paletteBlend == 3)? NOBLEND:LINEARBLEND);
+        c = RGBW32(fc.r, fc.g, fc.b, 0);
+      } break;
+      default:               c = RGBW32(p[0], p[1], p[2], 0); break;
+    }
+    if (fmt != PIXEL_FMT_PAL) c = gamma32(c); // palettes are already gamma corrected
+    i += psz;
+    for (unsigned end = min(pix + run, segLen); pix < end; pix++) seg.setPixelColor(pix, c);
+  }
+  seg.map1D2D = oldMap1D2D; // restore mapping
+  strip.trigger(); // force segment update
+  return true;
+}
+
 // deserializes WLED state
 // presetId is non-0 if called from handlePreset()
 bool deserializeState(JsonObject root, byte callMode, byte presetId)
@@ -446,6 +605,10 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   ps = root[F("pdel")]; //deletion
   if (ps > 0 && ps < 251) deletePreset(ps);
 
+  // RAM state slots (0-based)
+  if (!root[F("slotsave")].isNull()) saveStateSlot(root[F("slotsave")].as<int>());
+  if (!root[F("slot")].isNull()) recallStateSlot(root[F("slot")].as<int>(), callMode);
+
   // HTTP API commands (must be handled before "ps")
   const char* httpwin = root["win"];
   if (httpwin) {
@@ -579,6 +742,11 @@ void serializeSegment(JsonObject& root, Segment& seg, byte id, bool forPreset, b
   root["o3"]  = seg.check3;
   root["si"]  = seg.soundSim;
   root["m12"] = seg.map1D2D;
+  root["fps"] = seg.fps;
+  root[F("prio")] = seg.priority;
+  root[F("rtp")] = seg.rtProto;
+  root[F("rtu")] = seg.rtStart;
+  root[F("rtt")] = seg.rtTimeout;
 }
 
 void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool selectedSegmentsOnly)
@@ -616,8 +784,16 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
 
   root[F("mainseg")] = strip.getMainSegmentId();
 
+  if (!forPreset) {
+    // segments are serialized one at a time when printing (see printStateJson()), their number is not limited by JSON buffer
+    root["seg"] = serialized(segStreamMark);
+    return;
+  }
+
   JsonArray seg = root.createNestedArray("seg");
-  for (size_t s = 0; s < strip.getMaxSegments(); s++) {
+  // with large segment counts do not pad presets with hundreds of empty segments, 32 (or current number) is enough
+  const size_t maxSeg = min((size_t)strip.getMaxSegments(), max((size_t)32, (size_t)strip.getSegmentsNum()));
+  for (size_t s = 0; s < maxSeg; s++) {
     if (s >= strip.getSegmentsNum()) {
       if (forPreset && segmentBounds && !selectedSegmentsOnly) { //disable segments not part of preset
         JsonObject seg0 = seg.createNestedObject();
@@ -788,6 +964,19 @@ void serializeInfo(JsonObject root)
   getTimeString(time);
   root[F("time")] = time;
 
+  #ifdef WLED_DEBUG
+  JsonArray taskInfo = root.createNestedArray(F("tasks")); // main loop task timing
+  for (unsigned i = 0; i < getTaskCount(); i++) {
+    const sched_task_t *t = getTask(i);
+    JsonObject ti = taskInfo.createNestedObject();
+    ti["n"] = t->name;
+    ti["r"] = t->runs;
+    ti["d"] = t->deferred;
+    ti["t"] = t->cost;    // average [us]
+    ti["m"] = t->maxCost; // max [us]
+  }
+  #endif
+
   UsermodManager::addToJsonInfo(root);
 
   uint16_t os = 0;
@@ -890,6 +1079,12 @@ void serializePalettes(JsonObject root, int page)
 
   int start = itemPerPage * page;
   int end = start + itemPerPage;
+  if (page < 0) {
+    // custom palettes only (built-in ones are served from /palettes.json)
+    maxPage = 0;
+    start = palettesCount;
+    end = palettesCount + customPalettes;
+  }
   if (end > palettesCount + customPalettes) end = palettesCount + customPalettes;
 
   root[F("m")] = maxPage; // inform caller how many pages there are
@@ -1052,6 +1247,85 @@ void serializeModeNames(JsonArray arr)
   }
 }
 
+// Print filter that expands the segment placeholder left by serializeState() into the segment array
+// each segment is serialized into a small document of its own
+class SegmentStreamPrint : public Print {
+    Print &_dest;
+    DynamicJsonDocument _segDoc;
+    size_t _written;
+
+    void printSegments() {
+      _written += _dest.write('[');
+      bool first = true;
+      for (size_t s = 0; s < strip.getSegmentsNum(); s++) {
+        Segment &sg = strip.getSegment(s);
+        if (!sg.isActive()) continue;
+        if (!first) _written += _dest.write(',');
+        first = false;
+        _segDoc.clear();
+        JsonObject seg0 = _segDoc.to<JsonObject>();
+        serializeSegment(seg0, sg, s);
+        _written += serializeJson(_segDoc, _dest);
+      }
+      _written += _dest.write(']');
+    }
+
+  public:
+    SegmentStreamPrint(Print &dest) : _dest(dest), _segDoc(JSON_SEGMENT_SIZE), _written(0) {}
+    size_t written() const { return _written; }
+    size_t write(uint8_t c) override {
+      if (c == JSON_SEG_MARK) printSegments();
+      else _written += _dest.write(c);
+      return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override {
+      for (size_t i = 0; i < size; i++) write(buffer[i]);
+      return size;
+    }
+};
+
+class JsonCountPrint : public Print {
+  public:
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t *, size_t size) override { return size; }
+};
+
+class JsonBufferPrint : public Print {
+    char  *_pos;
+    size_t _left;
+  public:
+    JsonBufferPrint(char *buf, size_t len) : _pos(buf), _left(len) {}
+    size_t left() const { return _left; }
+    size_t write(uint8_t c) override {
+      if (!_left) return 0;
+      *_pos++ = c;
+      _left--;
+      return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override { return this->Print::write(buffer, size); }
+};
+
+// serializes a document containing state (serializeState()) to dest, returns number of bytes written
+size_t printStateJson(JsonDocument &doc, Print &dest) {
+  SegmentStreamPrint out(dest);
+  serializeJson(doc, out);
+  return out.written();
+}
+
+size_t measureStateJson(JsonDocument &doc) {
+  JsonCountPrint counter;
+  return printStateJson(doc, counter);
+}
+
+// fills buffer of measureStateJson() size, segments may have changed since measuring (another task)
+// so the text is cut or padded with whitespace to exactly len bytes
+size_t serializeStateJson(JsonDocument &doc, char *buf, size_t len) {
+  JsonBufferPrint out(buf, len);
+  printStateJson(doc, out);
+  if (out.left()) memset(buf + len - out.left(), ' ', out.left());
+  return len;
+}
+
 // Global buffer locking response helper class (to make sure lock is released when AsyncJsonResponse is destroyed)
 class LockedJsonResponse: public AsyncJsonResponse {
   bool _holding_lock;
@@ -1148,6 +1422,26 @@ void serveJson(AsyncWebServerRequest* request)
 
   DEBUG_PRINTF_P(PSTR("JSON buffer size: %u for request: %d\n"), lDoc.memoryUsage(), subJson);
 
+  if (subJson == JSON_PATH_STATE || subJson == JSON_PATH_STATE_INFO || subJson == 0) {
+    // state streams its segments: render text once (also releases JSON buffer early) and send it from that buffer
+    size_t len = measureStateJson(*pDoc);
+    char *buf = static_cast<char*>(allocMem(len, MEM_BULK, MEM_OWNER_JSON));
+    if (buf) serializeStateJson(*pDoc, buf, len);
+    delete response; // releases JSON buffer lock
+    if (!buf) {
+      serveJsonError(request, 503, ERR_NOBUF);
+      return;
+    }
+    DEBUG_PRINTF_P(PSTR("JSON content length: %u\n"), len);
+    std::shared_ptr<char> text(buf, freeMem); // freed when response is destroyed
+    request->send(request->beginResponse(FPSTR(CONTENT_TYPE_JSON), len, [text, len](uint8_t *data, size_t maxLen, size_t index) -> size_t {
+      size_t n = min(maxLen, len - index);
+      memcpy(data, text.get() + index, n);
+      return n;
+    }));
+    return;
+  }
+
   [[maybe_unused]] size_t len = response->setLength();
   DEBUG_PRINTF_P(PSTR("JSON content length: %u\n"), len);
 
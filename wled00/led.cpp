@@ -73,6 +73,7 @@ byte scaledBri(byte in)
 
 //applies global brightness
 void applyBri() {
+  if (strip.isFading()) return; // nightlight fade owns strip brightness
   if (!realtimeMode || !arlsForceMaxBri)
   {
     strip.setBrightness(scaledBri(briT));
@@ -95,7 +96,8 @@ void stateUpdated(byte callMode) {
   //                     6: fx changed 7: hue 8: preset cycle 9: blynk 10: alexa 11: ws send only 12: button preset
   setValuesFromFirstSelectedSeg();
 
-  if (bri != briOld || stateChanged) {
+  bool changed = bri != briOld || stateChanged;
+  if (changed) {
     if (stateChanged) currentPreset = 0; //something changed, so we are no longer in the preset
 
     if (callMode != CALL_MODE_NOTIFICATION && callMode != CALL_MODE_NO_NOTIFY) notify(callMode);
@@ -128,6 +130,15 @@ void stateUpdated(byte callMode) {
   // notify usermods of state change
   UsermodManager::onStateChange(callMode);
 
+  // nothing changed (e.g. repeated API request or preset): do not restart transitions or effects
+  if (!changed) {
+    if (jsonTransitionOnce && !transitionActive) {
+      strip.setTransition(transitionDelay); // restore temporary transition
+      jsonTransitionOnce = false;
+    }
+    return;
+  }
+
   if (fadeTransition) {
     if (strip.getTransition() == 0) {
       jsonTransitionOnce = false;
@@ -208,6 +219,8 @@ void colorUpdated(byte callMode) {
 
 void handleNightlight()
 {
+  static unsigned long nlFadeStart = 0;
+  static unsigned      nlFadeMilestone = 0;
   unsigned long now = millis();
   if (now < 100 && lastNlUpdate > 0) lastNlUpdate = 0; // take care of millis() rollover
   if (now - lastNlUpdate < 100) return; // allow only 10 NL updates per second
@@ -243,12 +256,27 @@ void handleNightlight()
     float nper = (millis() - nightlightStartTime)/((float)nightlightDelayMs);
     if (nightlightMode == NL_MODE_FADE || nightlightMode == NL_MODE_COLORFADE)
     {
-      bri = briNlT + ((nightlightTargetBri - briNlT)*nper);
-      if (nightlightMode == NL_MODE_COLORFADE)                                         // color fading only is enabled with "NF=2"
+      // output is faded by strip every frame, (re)start it on init or when brightness was changed during nightlight
+      if (nlFadeStart != nightlightStartTime) {
+        nlFadeStart = nightlightStartTime;
+        nlFadeMilestone = 0;
+        for (unsigned i=0; i<4; i++) colNlT[i] = col[i];
+        strip.startFade(scaledBri(briNlT), scaledBri(nightlightTargetBri), nightlightDelayMs - min(nightlightDelayMs, uint32_t(millis() - nightlightStartTime)),
+                        RGBW32(colNlT[0], colNlT[1], colNlT[2], colNlT[3]), RGBW32(colSec[0], colSec[1], colSec[2], colSec[3]),
+                        nightlightMode == NL_MODE_COLORFADE);                          // color fading only is enabled with "NF=2"
+      }
+      // keep global state in sync without starting transitions or sending updates on every step
+      bri = briNlT + ((nightlightTargetBri - briNlT)*min(nper, 1.0f));
+      briOld = briT = bri;
+      if (nightlightMode == NL_MODE_COLORFADE)
       {
-        for (unsigned i=0; i<4; i++) col[i] = colNlT[i]+ ((colSec[i] - colNlT[i])*nper);   // fading from actual color to secondary color
+        for (unsigned i=0; i<4; i++) col[i] = colNlT[i]+ ((colSec[i] - colNlT[i])*min(nper, 1.0f));   // fading from actual color to secondary color
+      }
+      unsigned milestone = min(nper, 1.0f) * NL_FADE_MILESTONES;
+      if (milestone != nlFadeMilestone) {
+        nlFadeMilestone = milestone;
+        interfaceUpdateCallMode = CALL_MODE_NIGHTLIGHT; // update WS/MQTT clients only occasionally
       }
-      colorUpdated(CALL_MODE_NO_NOTIFY);
     }
     if (nper >= 1) //nightlight duration over
     {
@@ -258,6 +286,14 @@ void handleNightlight()
         bri = nightlightTargetBri;
         colorUpdated(CALL_MODE_NO_NOTIFY);
       }
+      if (nightlightMode == NL_MODE_FADE || nightlightMode == NL_MODE_COLORFADE)
+      {
+        strip.stopFade();
+        nlFadeStart = 0;
+        colorUpdated(CALL_MODE_NO_NOTIFY); // apply exact final color to segments
+        applyFinalBri();
+        interfaceUpdateCallMode = CALL_MODE_NIGHTLIGHT;
+      }
       if (bri == 0) briLast = briNlT;
       if (nightlightMode == NL_MODE_SUN)
       {
@@ -276,6 +312,11 @@ void handleNightlight()
     }
   } else if (nightlightActiveOld) //early de-init
   {
+    if (strip.isFading()) { //leave LEDs at current brightness
+      strip.stopFade();
+      nlFadeStart = 0;
+      applyFinalBri();
+    }
     if (nightlightMode == NL_MODE_SUN) { //restore previous effect
       effectCurrent = colNlT[0];
       effectSpeed = colNlT[1];
@@ -23,4 +23,5 @@
 */
 
 //#define MAX_LEDS 1500       // Maximum total LEDs. More than 1500 might create a low memory situation on ESP8266.
+//#define WLED_LARGE_INSTALL  // ESP32 (with PSRAM) driving many thousand LEDs: raises LED & universe limits (better set as build flag)
 //#define MDNS_NAME "wled"    // mDNS hostname, ie: *.local
@@ -13,6 +13,16 @@
 
 Timezone* tz;
 
+// local time cache: the offset to UTC only changes at DST transitions and the date only at local midnight
+static time_t       tzValidFrom  = 0;   // UTC range [tzValidFrom, tzNextChange) has a constant offset
+static time_t       tzNextChange = 0;
+static int32_t      tzOffset     = 0;   // seconds local time is ahead of UTC (incl. DST)
+static uint32_t     localTimeSec = 0;   // toki.second() localTime was last updated for
+static time_t       localTmTime  = 0;   // localTime the broken down fields belong to
+static time_t       localTmDay   = 0;   // local midnight of the cached date
+static bool         localTmValid = false;
+static tmElements_t localTm;
+
 #define TZ_UTC                  0
 #define TZ_UK                   1
 #define TZ_EUROPE_CENTRAL       2
@@ -155,6 +165,7 @@ void updateTimezone() {
   memcpy_P(&tcrStandard, &TZ_TABLE[tz_table_entry].second, sizeof(tcrStandard));
 
   tz = new Timezone(tcrDaylight, tcrStandard);
+  tzValidFrom = tzNextChange = 0; // force conversion with new rules
 }
 
 void handleTime() {
@@ -293,24 +304,58 @@ bool checkNTPResponse()
 void updateLocalTime()
 {
   if (currentTimezone != tzCurrent) updateTimezone();
-  unsigned long tmc = toki.second()+ utcOffsetSecs;
-  localTime = tz->toLocal(tmc);
+  localTimeSec = toki.second();
+  time_t tmc = localTimeSec + utcOffsetSecs;
+  // only convert through Timezone if a DST change is due or the clock was set back
+  if (tmc >= tzNextChange || tmc < tzValidFrom) {
+    tzOffset     = (int32_t)(tz->toLocal(tmc) - tmc);
+    tzNextChange = tz->nextChange(tmc);
+    tzValidFrom  = tmc;
+  }
+  localTime = tmc + tzOffset;
+}
+
+// refreshes broken down localTime (also follows countdown mode), date fields are only recalculated on a new day
+static void refreshLocalTm()
+{
+  if (localTmValid && localTime == localTmTime) return;
+  localTmTime = localTime;
+  if (!localTmValid || previousMidnight(localTime) != localTmDay) {
+    breakTime(localTime, localTm);
+    localTmDay = previousMidnight(localTime);
+    localTmValid = true;
+    return;
+  }
+  localTm.Hour   = numberOfHours(localTime);
+  localTm.Minute = numberOfMinutes(localTime);
+  localTm.Second = numberOfSeconds(localTime);
 }
 
+// cheap replacements for hour(localTime) etc.
+uint8_t  localHour()    { refreshLocalTm(); return localTm.Hour; }
+uint8_t  localMinute()  { refreshLocalTm(); return localTm.Minute; }
+uint8_t  localSecond()  { refreshLocalTm(); return localTm.Second; }
+uint8_t  localWeekday() { refreshLocalTm(); return localTm.Wday; } // 1 = Sunday
+uint8_t  localDay()     { refreshLocalTm(); return localTm.Day; }
+uint8_t  localMonth()   { refreshLocalTm(); return localTm.Month; }
+uint16_t localYear()    { refreshLocalTm(); return tmYearToCalendar(localTm.Year); }
+// ms since start of current second (smooth clock hands), stays at 999 until localTime was updated for a new second
+uint16_t localMillis()  { return toki.second() == localTimeSec ? toki.millisecond() : 999; }
+
 void getTimeString(char* out)
 {
   updateLocalTime();
-  byte hr = hour(localTime);
+  byte hr = localHour();
   if (useAMPM)
   {
     if (hr > 11) hr -= 12;
     if (hr == 0) hr  = 12;
   }
-  sprintf_P(out,PSTR("%i-%i-%i, %02d:%02d:%02d"),year(localTime), month(localTime), day(localTime), hr, minute(localTime), second(localTime));
+  sprintf_P(out,PSTR("%i-%i-%i, %02d:%02d:%02d"),localYear(), localMonth(), localDay(), hr, localMinute(), localSecond());
   if (useAMPM)
   {
     strcat_P(out,PSTR(" "));
-    strcat(out,(hour(localTime) > 11)? "PM":"AM");
+    strcat(out,(localHour() > 11)? "PM":"AM");
   }
 }
 
@@ -340,7 +385,7 @@ bool checkCountdown()
 
 byte weekdayMondayFirst()
 {
-  byte wd = weekday(localTime) -1;
+  byte wd = localWeekday() -1;
   if (wd == 0) wd = 7;
   return wd;
 }
@@ -350,8 +395,8 @@ bool isTodayInDateRange(byte monthStart, byte dayStart, byte monthEnd, byte dayE
 	if (monthStart == 0 || dayStart == 0) return true;
 	if (monthEnd == 0) monthEnd = monthStart;
 	if (dayEnd == 0) dayEnd = 31;
-	byte d = day(localTime);
-	byte m = month(localTime);
+	byte d = localDay();
+	byte m = localMonth();
 
 	if (monthStart < monthEnd) {
 		if (m > monthStart && m < monthEnd) return true;
@@ -373,20 +418,26 @@ bool isTodayInDateRange(byte monthStart, byte dayStart, byte monthEnd, byte dayE
 
 void checkTimers()
 {
-  if (lastTimerMinute != minute(localTime)) //only check once a new minute begins
+  if (lastTimerMinute != localMinute()) //only check once a new minute begins
   {
-    lastTimerMinute = minute(localTime);
+    lastTimerMinute = localMinute();
+
+    // do not check minutes twice when the clock is set back by less than an hour (end of DST)
+    static time_t lastCheckedMinute = 0;
+    const time_t thisMinute = localTime - localSecond();
+    if (thisMinute <= lastCheckedMinute && lastCheckedMinute - thisMinute < SECS_PER_HOUR) return;
+    lastCheckedMinute = thisMinute;
 
     // re-calculate sunrise and sunset just after midnight
-    if (!hour(localTime) && minute(localTime)==1) calculateSunriseAndSunset();
+    if (!localHour() && localMinute()==1) calculateSunriseAndSunset();
 
-    DEBUG_PRINTF_P(PSTR("Local time: %02d:%02d\n"), hour(localTime), minute(localTime));
+    DEBUG_PRINTF_P(PSTR("Local time: %02d:%02d\n"), localHour(), localMinute());
     for (unsigned i = 0; i < 8; i++)
     {
       if (timerMacro[i] != 0
           && (timerWeekday[i] & 0x01) //timer is enabled
-          && (timerHours[i] == hour(localTime) || timerHours[i] == 24) //if hour is set to 24, activate every hour
-          && timerMinutes[i] == minute(localTime)
+          && (timerHours[i] == localHour() || timerHours[i] == 24) //if hour is set to 24, activate every hour
+          && timerMinutes[i] == localMinute()
           && ((timerWeekday[i] >> weekdayMondayFirst()) & 0x01) //timer should activate at current day of week
           && isTodayInDateRange(((timerMonth[i] >> 4) & 0x0F), timerDay[i], timerMonth[i] & 0x0F, timerDayEnd[i])
          )
@@ -399,8 +450,8 @@ void checkTimers()
       time_t tmp = sunrise + timerMinutes[8]*60;  // NOTE: may not be ok
       DEBUG_PRINTF_P(PSTR("Trigger time: %02d:%02d\n"), hour(tmp), minute(tmp));
       if (timerMacro[8] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
+          && hour(tmp) == localHour()
+          && minute(tmp) == localMinute()
           && (timerWeekday[8] & 0x01) //timer is enabled
           && ((timerWeekday[8] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
       {
@@ -413,8 +464,8 @@ void checkTimers()
       time_t tmp = sunset + timerMinutes[9]*60;  // NOTE: may not be ok
       DEBUG_PRINTF_P(PSTR("Trigger time: %02d:%02d\n"), hour(tmp), minute(tmp));
       if (timerMacro[9] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
+          && hour(tmp) == localHour()
+          && minute(tmp) == localMinute()
           && (timerWeekday[9] & 0x01) //timer is enabled
           && ((timerWeekday[9] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
       {
@@ -483,9 +534,9 @@ static int getSunriseUTC(int year, int month, int day, float lat, float lon, boo
 void calculateSunriseAndSunset() {
   if ((int)(longitude*10.) || (int)(latitude*10.)) {
     struct tm tim_0;
-    tim_0.tm_year = year(localTime)-1900;
-    tim_0.tm_mon = month(localTime)-1;
-    tim_0.tm_mday = day(localTime);
+    tim_0.tm_year = localYear()-1900;
+    tim_0.tm_mon = localMonth()-1;
+    tim_0.tm_mday = localDay();
     tim_0.tm_sec = 0;
     tim_0.tm_isdst = 0;
 
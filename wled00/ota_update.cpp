@@ -0,0 +1,215 @@
+#include "wled.h"
+
+/*
+ * Firmware update via HTTP upload (/update)
+ *
+ * On ESP32 received chunks are queued into a bounded ring buffer and written to flash
+ * by a low priority task, so the effect loop keeps rendering during the upload.
+ * The new image only becomes active after reboot. If the bootloader supports app rollback,
+ * the new image is marked valid once it has been running for OTA_CONFIRM_DELAY.
+ * ESP8266 writes synchronously (with LED output suspended) as before.
+ */
+
+#ifndef WLED_DISABLE_OTA
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <freertos/ringbuf.h>
+#include <mbedtls/sha256.h>
+#include <esp_ota_ops.h>
+
+#ifndef OTA_BUFFER_SIZE
+  #define OTA_BUFFER_SIZE   16384   // bytes queued between web server and flash writer
+#endif
+#define OTA_WRITE_CHUNK     4096    // max bytes written to flash per writer iteration
+#define OTA_WRITE_PAUSE     2       // ticks the writer yields after each chunk (throughput limit)
+#define OTA_QUEUE_TIMEOUT   20      // ms the web server may wait for space in the ring (must not stall async_tcp)
+#define OTA_DRAIN_TIMEOUT   30000   // ms to wait for the writer to flush at the end of upload
+#define OTA_CONFIRM_DELAY   30000   // ms of uptime after which a freshly flashed image is marked valid
+
+static RingbufHandle_t   otaRing = nullptr;
+static SemaphoreHandle_t otaDone = nullptr;
+static TaskHandle_t      otaTask = nullptr;
+static volatile bool     otaInputDone = false;
+static volatile bool     otaFailed = false;
+static mbedtls_sha256_context otaSha;
+static uint8_t           otaExpectedSha[32];
+static bool              otaCheckSha = false;
+
+// defer the Arduino core's automatic "app valid" marking until WLED has proven to run (see handleOTA())
+extern "C" bool verifyRollbackLater() { return true; }
+
+static void otaWriter(void *) {
+  for (;;) {
+    size_t len = 0;
+    uint8_t *chunk = (uint8_t*)xRingbufferReceiveUpTo(otaRing, &len, pdMS_TO_TICKS(100), OTA_WRITE_CHUNK);
+    if (chunk) {
+      if (!otaFailed) {
+        mbedtls_sha256_update_ret(&otaSha, chunk, len);
+        if (Update.write(chunk, len) != len) otaFailed = true;
+      }
+      vRingbufferReturnItem(otaRing, chunk);
+      vTaskDelay(OTA_WRITE_PAUSE); // leave flash bus and CPU to rendering
+    } else if (otaInputDone) break; // all data written
+  }
+  xSemaphoreGive(otaDone);
+  vTaskDelete(nullptr);
+}
+
+// waits for the writer task to finish and frees its resources, returns false if it is stuck
+static bool otaStopWriter() {
+  if (!otaRing) return true;
+  otaInputDone = true;
+  if (xSemaphoreTake(otaDone, pdMS_TO_TICKS(OTA_DRAIN_TIMEOUT)) != pdTRUE) {
+    otaFailed = true;
+    return false; // do not free buffers still in use, device will need a reboot anyway
+  }
+  vRingbufferDelete(otaRing);
+  vSemaphoreDelete(otaDone);
+  otaRing = nullptr;
+  otaDone = nullptr;
+  otaTask = nullptr;
+  return true;
+}
+
+static bool parseSha256(const char *hex, uint8_t *out) {
+  if (!hex || strlen(hex) != 64) return false;
+  for (unsigned i = 0; i < 32; i++) {
+    char b[3] = {hex[2*i], hex[2*i+1], 0};
+    char *end;
+    out[i] = strtoul(b, &end, 16);
+    if (*end) return false;
+  }
+  return true;
+}
+#endif
+
+static bool otaActive = false;
+
+static void otaFinish(bool success) {
+  otaActive = false;
+  if (success) {
+    DEBUG_PRINTLN(F("Update Success"));
+    return;
+  }
+  DEBUG_PRINTLN(F("Update Failed"));
+  strip.resume();
+  UsermodManager::onUpdateBegin(false); // notify usermods that update has failed (some may require task init)
+  #if WLED_WATCHDOG_TIMEOUT > 0
+  WLED::instance().enableWatchdog();
+  #endif
+}
+
+// starts an update, sha256 is an optional hex digest of the image to verify against
+bool otaBegin(const char *sha256) {
+  if (otaActive) return false;
+  #ifdef ARDUINO_ARCH_ESP32
+  if (otaRing) return false; // writer of a previous failed update still stuck
+  #endif
+  DEBUG_PRINTLN(F("OTA Update Start"));
+  #if WLED_WATCHDOG_TIMEOUT > 0
+  WLED::instance().disableWatchdog();
+  #endif
+  UsermodManager::onUpdateBegin(true); // notify usermods that update is about to begin (some may require task de-init)
+  lastEditTime = millis(); // make sure PIN does not lock during update
+  otaActive = true;
+  #ifdef ESP8266
+  strip.suspend();
+  strip.resetSegments();  // free as much memory as you can
+  Update.runAsync(true);
+  #endif
+  if (!Update.begin((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000)) {
+    otaFinish(false);
+    return false;
+  }
+  #ifdef ARDUINO_ARCH_ESP32
+  otaInputDone = false;
+  otaFailed = false;
+  otaCheckSha = parseSha256(sha256, otaExpectedSha);
+  mbedtls_sha256_init(&otaSha);
+  mbedtls_sha256_starts_ret(&otaSha, 0);
+  otaRing = xRingbufferCreate(OTA_BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF);
+  otaDone = xSemaphoreCreateBinary();
+  if (!otaRing || !otaDone || xTaskCreate(otaWriter, "otaWriter", 6144, nullptr, tskIDLE_PRIORITY+1, &otaTask) != pdPASS) {
+    // not enough memory for background writing, fall back to writing from the web server with LEDs suspended
+    DEBUG_PRINTLN(F("OTA: no background writer."));
+    if (otaRing) vRingbufferDelete(otaRing);
+    if (otaDone) vSemaphoreDelete(otaDone);
+    otaRing = nullptr;
+    otaDone = nullptr;
+    otaTask = nullptr;
+    strip.suspend();
+  }
+  #endif
+  return true;
+}
+
+bool otaWrite(const uint8_t *data, size_t len) {
+  if (!otaActive || Update.hasError()) return false;
+  #ifdef ARDUINO_ARCH_ESP32
+  if (otaRing) {
+    while (len > 0 && !otaFailed) {
+      size_t n = min(len, (size_t)OTA_BUFFER_SIZE/2); // byte buffer accepts at most half its size per item
+      // only waits briefly for the writer to make room, a stalled writer fails the update instead of blocking the web server
+      if (xRingbufferSend(otaRing, data, n, pdMS_TO_TICKS(OTA_QUEUE_TIMEOUT)) != pdTRUE) otaFailed = true;
+      data += n;
+      len  -= n;
+    }
+    return !otaFailed;
+  }
+  mbedtls_sha256_update_ret(&otaSha, data, len);
+  #endif
+  return Update.write((uint8_t*)data, len) == len;
+}
+
+// finalizes the update, returns true if the new image will boot on next restart
+bool otaEnd() {
+  if (!otaActive) return false;
+  #ifdef ARDUINO_ARCH_ESP32
+  bool ok = otaStopWriter() && !otaFailed;
+  if (ok && otaCheckSha) {
+    uint8_t sha[32];
+    mbedtls_sha256_finish_ret(&otaSha, sha);
+    if (memcmp(sha, otaExpectedSha, sizeof(sha)) != 0) {
+      DEBUG_PRINTLN(F("OTA: SHA-256 mismatch!"));
+      ok = false;
+    }
+  }
+  if (!otaRing) mbedtls_sha256_free(&otaSha);
+  if (!ok) {
+    Update.abort();
+    otaFinish(false);
+    return false;
+  }
+  #endif
+  bool success = Update.end(true);
+  otaFinish(success);
+  return success;
+}
+
+// called if the client goes away before the last chunk arrived
+void otaAbort() {
+  if (!otaActive) return;
+  #ifdef ARDUINO_ARCH_ESP32
+  otaFailed = true;
+  otaStopWriter();
+  if (!otaRing) mbedtls_sha256_free(&otaSha);
+  Update.abort();
+  #endif
+  otaFinish(false);
+}
+
+void handleOTA() {
+  #ifdef ARDUINO_ARCH_ESP32
+  static bool confirmed = false;
+  if (confirmed || millis() < OTA_CONFIRM_DELAY) return;
+  confirmed = true;
+  const esp_partition_t *running = esp_ota_get_running_partition();
+  esp_ota_img_states_t state;
+  if (esp_ota_get_state_partition(running, &state) == ESP_OK && state == ESP_OTA_IMG_PENDING_VERIFY) {
+    DEBUG_PRINTLN(F("OTA: new firmware confirmed."));
+    esp_ota_mark_app_valid_cancel_rollback();
+  }
+  #endif
+}
+
+#endif
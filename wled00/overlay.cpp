@@ -11,10 +11,10 @@ void _overlayAnalogClock()
   {
     _overlayAnalogCountdown(); return;
   }
-  float hourP = ((float)(hour(localTime)%12))/12.0f;
-  float minuteP = ((float)minute(localTime))/60.0f;
+  float hourP = ((float)(localHour()%12))/12.0f;
+  float minuteP = ((float)localMinute())/60.0f;
   hourP = hourP + minuteP/12.0f;
-  float secondP = ((float)second(localTime))/60.0f;
+  float secondP = ((float)localSecond() + localMillis()/1000.0f)/60.0f; // include sub-second phase for smooth movement
   unsigned hourPixel = floorf(analogClock12pixel + overlaySize*hourP);
   if (hourPixel > overlayMax) hourPixel = overlayMin -1 + hourPixel - overlayMax;
   unsigned minutePixel = floorf(analogClock12pixel + overlaySize*minuteP);
@@ -16,6 +16,21 @@ static char *quickLoad = nullptr;
 static char *saveName = nullptr;
 static bool includeBri = true, segBounds = true, selectedOnly = false, playlistSave = false;;
 
+/*
+ * RAM state slots hold a complete copy of all segments for instant recall (no file system or JSON involved)
+ */
+typedef struct StateSlot {
+  std::vector<Segment> segments;
+  uint8_t mainSegment;
+  uint8_t bri;
+  uint8_t ledmap;
+} state_slot_t;
+
+static state_slot_t *stateSlots[WLED_MAX_STATE_SLOTS] = {nullptr};
+static volatile int8_t slotToSave = -1;
+static volatile int8_t slotToRecall = -1;
+static volatile byte callModeSlot = 0;
+
 static const char presets_json[] PROGMEM = "/presets.json";
 static const char tmp_json[] PROGMEM = "/tmp.json";
 const char *getPresetsFileName(bool persistent) {
@@ -50,24 +65,31 @@ static void doSaveState() {
     DEBUG_PRINTLN();
   #endif
 */
-  #if defined(ARDUINO_ARCH_ESP32)
-  if (!persist) {
-    if (tmpRAMbuffer!=nullptr) free(tmpRAMbuffer);
-    size_t len = measureJson(*pDoc) + 1;
-    DEBUG_PRINTLN(len);
-    // if possible use SPI RAM on ESP32
-    if (psramSafe && psramFound())
-      tmpRAMbuffer = (char*) ps_malloc(len);
-    else
-      tmpRAMbuffer = (char*) malloc(len);
-    if (tmpRAMbuffer!=nullptr) {
-      serializeJson(*pDoc, tmpRAMbuffer, len);
-    } else {
-      writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
-    }
-  } else
-  #endif
-  writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
+  // presets are stored as one JSON object, with many segments it may not fit (RAM state slots have no such limit)
+  if (pDoc->overflowed()) {
+    DEBUG_PRINTLN(F("Preset does not fit into JSON buffer!"));
+    errorFlag = ERR_NOBUF;
+    persist = false; // do not write a truncated preset
+  } else {
+    #if defined(ARDUINO_ARCH_ESP32)
+    if (!persist) {
+      if (tmpRAMbuffer!=nullptr) free(tmpRAMbuffer);
+      size_t len = measureJson(*pDoc) + 1;
+      DEBUG_PRINTLN(len);
+      // if possible use SPI RAM on ESP32
+      if (psramSafe && psramFound())
+        tmpRAMbuffer = (char*) ps_malloc(len);
+      else
+        tmpRAMbuffer = (char*) malloc(len);
+      if (tmpRAMbuffer!=nullptr) {
+        serializeJson(*pDoc, tmpRAMbuffer, len);
+      } else {
+        writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
+      }
+    } else
+    #endif
+    writeObjectToFileUsingId(getPresetsFileName(persist), presetToSave, pDoc);
+  }
 
   if (persist) presetsModifiedTime = toki.second(); //unix time
   releaseJSONBufferLock();
@@ -83,6 +105,59 @@ static void doSaveState() {
   playlistSave = false;
 }
 
+static void doSaveStateSlot(unsigned slot) {
+  if (!stateSlots[slot]) stateSlots[slot] = new state_slot_t;
+  if (!stateSlots[slot]) return;
+  state_slot_t &s = *stateSlots[slot];
+  s.segments.clear();
+  s.segments.reserve(strip._segments.size());
+  for (const Segment &seg : strip._segments) s.segments.push_back(seg.cloneSettings()); // no effect RAM, effect restarts on recall
+  s.mainSegment = strip.getMainSegmentId();
+  s.bri         = bri;
+  s.ledmap      = currentLedmap;
+  DEBUG_PRINTF_P(PSTR("State slot %u saved (%u segments).\n"), slot, s.segments.size());
+}
+
+static void doRecallStateSlot(unsigned slot, byte callMode) {
+  const state_slot_t &s = *stateSlots[slot];
+  bool sameLayout = s.segments.size() == strip._segments.size();
+  for (size_t i = 0; sameLayout && i < s.segments.size(); i++) {
+    const Segment &a = s.segments[i], &b = strip._segments[i];
+    sameLayout = a.start == b.start && a.stop == b.stop && a.startY == b.startY && a.stopY == b.stopY;
+  }
+  if (sameLayout) {
+    uint16_t dur = fadeTransition ? strip.getTransition() : 0;
+    for (size_t i = 0; i < s.segments.size(); i++) strip._segments[i].restore(s.segments[i], dur);
+  } else {
+    strip.fill(BLACK); // clear pixels not covered by new segments
+    strip._segments = s.segments;
+    strip.fixInvalidSegments(); // in case LED configuration changed since saving
+  }
+  strip.setMainSegmentId(s.mainSegment);
+  if (s.ledmap != currentLedmap) loadLedmap = s.ledmap;
+  bri = s.bri;
+  stateChanged = true;
+  strip.trigger();
+  stateUpdated(callMode);
+  DEBUG_PRINTF_P(PSTR("State slot %u recalled.\n"), slot);
+}
+
+// stores current segments into RAM slot (applied in handlePresets())
+bool saveStateSlot(byte slot) {
+  if (slot >= WLED_MAX_STATE_SLOTS) return false;
+  slotToSave = slot;
+  return true;
+}
+
+// restores segments from RAM slot (applied in handlePresets())
+bool recallStateSlot(byte slot, byte callMode) {
+  if (slot >= WLED_MAX_STATE_SLOTS || !stateSlots[slot]) return false;
+  unloadPlaylist();
+  slotToRecall = slot;
+  callModeSlot = callMode;
+  return true;
+}
+
 bool getPresetName(byte index, String& name)
 {
   if (!requestJSONBufferLock(19)) return false;
@@ -144,6 +219,15 @@ void applyPresetWithFallback(uint8_t index, uint8_t callMode, uint8_t effectID,
 void handlePresets()
 {
   byte presetErrFlag = ERR_NONE;
+  if (slotToSave >= 0) {
+    doSaveStateSlot(slotToSave);
+    slotToSave = -1;
+  }
+  if (slotToRecall >= 0) {
+    doRecallStateSlot(slotToRecall, callModeSlot);
+    slotToRecall = -1;
+    callModeSlot = 0;
+  }
   if (presetToSave) {
     strip.suspend();
     doSaveState();
@@ -0,0 +1,65 @@
+#include "wled.h"
+
+/*
+ * Cooperative scheduler for periodic background work of the main loop.
+ * Each task registers its period, priority and an estimate of its run time (in us).
+ * High priority tasks run whenever they are due. Low priority tasks only run if their
+ * estimated cost fits into the time left until the next LED frame is due, unless they
+ * have been postponed for more than TASK_STARVATION_MS (or 4 periods).
+ * The estimate is replaced by a running average of the measured run time.
+ * A task is due as soon as it is registered (first run does not wait one period).
+ */
+
+static sched_task_t tasks[WLED_MAX_TASKS];
+static uint8_t taskCount = 0;
+
+// registers a task, tasks are kept ordered by priority (stable for equal priority)
+bool addTask(const char *name, task_fn_t fn, uint16_t period, uint8_t priority, uint16_t estCost) {
+  if (!fn || taskCount >= WLED_MAX_TASKS) return false;
+  unsigned pos = taskCount;
+  while (pos > 0 && tasks[pos-1].priority < priority) {
+    tasks[pos] = tasks[pos-1];
+    pos--;
+  }
+  tasks[pos] = {name, fn, period, priority, millis() - period, estCost, 0, 0, 0};
+  taskCount++;
+  DEBUG_PRINTF_P(PSTR("Task %s: %ums, prio %u\n"), name, period, priority);
+  return true;
+}
+
+// time (in ms) until strip.service() has to render the next frame
+unsigned getFrameSlack() {
+  if (offMode && !strip.isOffRefreshRequired() && !strip.needsUpdate()) return UINT16_MAX; // nothing to render
+  unsigned elapsed   = millis() - strip.getLastShow();
+  unsigned frameTime = strip.getFrameTime();
+  return elapsed < frameTime ? frameTime - elapsed : 0;
+}
+
+void handleTasks() {
+  for (unsigned i = 0; i < taskCount; i++) {
+    sched_task_t &t = tasks[i];
+    uint32_t now = millis();
+    uint32_t since = now - t.lastRun;
+    if (since < t.period) continue;
+    if (t.priority == TASK_PRIO_LOW && since < MAX(TASK_STARVATION_MS, 4U*t.period) && t.cost > getFrameSlack()*1000U) {
+      t.deferred++;
+      continue;
+    }
+    uint32_t start = micros();
+    t.fn();
+    uint32_t took = micros() - start;
+    t.cost = (t.cost*7 + took) / 8;
+    if (took > t.maxCost) t.maxCost = took;
+    t.runs++;
+    t.lastRun = now;
+    yield();
+  }
+}
+
+uint8_t getTaskCount() {
+  return taskCount;
+}
+
+const sched_task_t *getTask(uint8_t i) {
+  return i < taskCount ? &tasks[i] : nullptr;
+}
@@ -141,6 +141,24 @@ boolean Timezone::locIsDST(time_t local)
         return !(local >= _stdLoc && local < _dstLoc);
 }
 
+/*----------------------------------------------------------------------*
+ * Return the UTC time of the next DST or standard time change after    *
+ * the given UTC time. The offset returned by toLocal() is constant     *
+ * until then (WLED addition).                                          *
+ *----------------------------------------------------------------------*/
+time_t Timezone::nextChange(time_t utc)
+{
+    int yr = year(utc);
+    if (yr != year(_dstUTC)) calcTimeChanges(yr);
+
+    time_t first  = _dstUTC < _stdUTC ? _dstUTC : _stdUTC;
+    time_t second = _dstUTC < _stdUTC ? _stdUTC : _dstUTC;
+    if (utc < first) return first;
+    if (utc < second) return second;
+    calcTimeChanges(yr + 1);
+    return _dstUTC < _stdUTC ? _dstUTC : _stdUTC;
+}
+
 /*----------------------------------------------------------------------*
  * Calculate the DST and standard time change points for the given      *
  * given year as local and UTC time_t values.                           *
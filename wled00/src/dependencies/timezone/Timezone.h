@@ -45,6 +45,7 @@ class Timezone
         time_t toUTC(time_t local);
         boolean utcIsDST(time_t utc);
         boolean locIsDST(time_t local);
+        time_t nextChange(time_t utc);  //WLED: UTC of the next time change after utc
         void readRules(int address);
         void writeRules(int address);
 
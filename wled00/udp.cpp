@@ -6,7 +6,8 @@
 
 #define UDP_SEG_SIZE 36
 #define SEG_OFFSET (41)
-#define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+0)
+#define UDP_MAX_SEGMENTS (MAX_NUM_SEGMENTS < 32 ? MAX_NUM_SEGMENTS : 32) // sync packet must fit into one UDP datagram
+#define WLEDPACKETSIZE (41+(UDP_MAX_SEGMENTS*UDP_SEG_SIZE)+0)
 #define UDP_IN_MAXSIZE 1472
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
 
@@ -100,12 +101,13 @@ void notify(byte callMode, bool followUp)
   udpOut[37] = strip.hasCCTBus() ? 0 : 255; //check this is 0 for the next value to be significant
   udpOut[38] = mainseg.cct;
 
-  udpOut[39] = strip.getActiveSegmentsNum();
+  udpOut[39] = min((unsigned)strip.getActiveSegmentsNum(), (unsigned)UDP_MAX_SEGMENTS);
   udpOut[40] = UDP_SEG_SIZE; //size of each loop iteration (one segment)
   size_t s = 0, nsegs = strip.getSegmentsNum();
   for (size_t i = 0; i < nsegs; i++) {
     Segment &selseg = strip.getSegment(i);
     if (!selseg.isActive()) continue;
+    if (s >= UDP_MAX_SEGMENTS) break; // only first 32 active segments are synced
     unsigned ofs = 41 + s*UDP_SEG_SIZE; //start of segment offset byte
     udpOut[0 +ofs] = s;
     udpOut[1 +ofs] = selseg.start >> 8;
@@ -469,6 +471,21 @@ void sendTPM2Ack() {
   notifierUdp.endPacket();
 }
 
+// UDP realtime packet for segments bound to REALTIME_MODE_UDP, returns true if it was consumed
+static bool handleSegmentRealtimeUDP(const uint8_t *buf, size_t len) {
+  switch (buf[0]) {
+    case 1: { // warls: [index,R,G,B]...
+      bool bound = false;
+      for (size_t i = 2; i + 3 < len; i += 4) bound |= setSegmentRealtimePixels(REALTIME_MODE_UDP, buf[i], &buf[i+1], 1, 3);
+      return bound;
+    }
+    case 2: return len > 4 && setSegmentRealtimePixels(REALTIME_MODE_UDP, 0, &buf[2], (len-2)/3, 3); // drgb
+    case 3: return len > 6 && setSegmentRealtimePixels(REALTIME_MODE_UDP, 0, &buf[2], (len-2)/4, 4); // drgbw
+    case 4: return len > 7 && setSegmentRealtimePixels(REALTIME_MODE_UDP, (buf[2] << 8) | buf[3], &buf[4], (len-4)/3, 3); // dnrgb
+  }
+  return false;
+}
+
 
 void handleNotifications()
 {
@@ -479,7 +496,8 @@ void handleNotifications()
     notify(notificationSentCallMode,true);
   }
 
-  if (e131NewData && millis() - strip.getLastShow() > 15)
+  // realtime data from one or more packets is pushed to LEDs at most every REALTIME_SHOW_INTERVAL ms
+  if (e131NewData && millis() - strip.getLastShow() > REALTIME_SHOW_INTERVAL)
   {
     e131NewData = false;
     strip.show();
@@ -517,7 +535,7 @@ void handleNotifications()
         setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
         id++; if (id >= totalLen) break;
       }
-      if (!(realtimeMode && useMainSegmentOnly)) strip.show();
+      if (!(realtimeMode && useMainSegmentOnly)) e131NewData = true;
       return;
     }
   }
@@ -607,7 +625,7 @@ void handleNotifications()
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
-      strip.show();
+      e131NewData = true;
     }
     return;
   }
@@ -619,6 +637,8 @@ void handleNotifications()
     DEBUG_PRINTLN(realtimeIP);
     if (packetSize < 2) return;
 
+    if (handleSegmentRealtimeUDP(udpIn, packetSize)) return; // drawn by strip.service()
+
     if (udpIn[1] == 0)
     {
       realtimeTimeout = 0;
@@ -672,7 +692,7 @@ void handleNotifications()
         id++;
       }
     }
-    strip.show();
+    e131NewData = true; // coalesce with following (partial) updates
     return;
   }
 
@@ -713,6 +733,44 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
   }
 }
 
+// copies pixels [first, first+count) of a realtime source into the buffers of segments bound to that part of the source
+// (E1.31/Art-Net pixels are counted from universe 0 with 170 pixels per universe)
+// may be called from network task: it only uses the bindings table published by strip.service() (never the segments)
+// and holds SEG_RT_LOCK meanwhile, pixels are drawn by strip.service() on loop task
+// seq >= 0 is E1.31/Art-Net sequence number, out of sequence data is skipped for each bound segment
+// returns false if no segment is bound to it, the data is then handled by the strip wide realtime mode
+bool setSegmentRealtimePixels(byte proto, unsigned first, const uint8_t *data, unsigned count, unsigned channels, int seq)
+{
+  bool bound = false;
+  const bool gamma = !arlsDisableGammaCorrection && gammaCorrectCol;
+  const unsigned long t = millis();
+  SEG_RT_LOCK();
+  for (unsigned n = 0; n < strip._rtBindingCount; n++) {
+    rt_binding_t &b = strip._rtBindings[n];
+    if (b.proto != proto) continue;
+    unsigned from = max(first, (unsigned)b.first);
+    unsigned to   = min(first + count, (unsigned)b.first + b.len);
+    if (from >= to) continue;
+    bound = true;
+    if (seq >= 0 && b.seq) {
+      uint8_t &lastSeq = b.seq[(first - b.first) / MAX_3_CH_LEDS_PER_UNIVERSE]; // universe within segment
+      if (seq < lastSeq && seq > 20 && lastSeq < 250) continue;
+      lastSeq = seq;
+    }
+    for (unsigned i = from; i < to; i++) {
+      const uint8_t *c = data + (i - first) * channels;
+      byte w = channels > 3 ? c[3] : 0;
+      if (gamma) b.data[i - b.first] = RGBW32(gamma8(c[0]), gamma8(c[1]), gamma8(c[2]), gamma8(w));
+      else       b.data[i - b.first] = RGBW32(c[0], c[1], c[2], w);
+    }
+    b.fresh = true;
+    b.until = t + (b.timeout ? b.timeout : realtimeTimeoutMs); // effect is paused until then
+  }
+  SEG_RT_UNLOCK();
+  if (bound) Segment::rtPending = true;
+  return bound;
+}
+
 /*********************************************************************************************\
    Refresh aging for remote units, drop if too old...
 \*********************************************************************************************/
@@ -1010,12 +1068,12 @@ void espNowReceiveCB(uint8_t* address, uint8_t* data, uint8_t len, signed int rs
     segsReceived = (len - 3 - 41) / UDP_SEG_SIZE;
   } else if (buffer->packet == packetsReceived && udpIn && ((len - 3) / UDP_SEG_SIZE) * UDP_SEG_SIZE == (len-3)) {
     // we received a packet full of segments
-    if (segsReceived >= MAX_NUM_SEGMENTS) {
+    if (segsReceived >= UDP_MAX_SEGMENTS) {
       // we are already past max segments, just ignore
       DEBUG_PRINTLN(F("ESP-NOW received segments past maximum."));
       len = 3;
-    } else if ((segsReceived + ((len - 3) / UDP_SEG_SIZE)) >= MAX_NUM_SEGMENTS) {
-      len = ((MAX_NUM_SEGMENTS - segsReceived) * UDP_SEG_SIZE) + 3; // we have reached max number of segments
+    } else if ((segsReceived + ((len - 3) / UDP_SEG_SIZE)) >= UDP_MAX_SEGMENTS) {
+      len = ((UDP_MAX_SEGMENTS - segsReceived) * UDP_SEG_SIZE) + 3; // we have reached max number of segments
     }
     if (len > 3) {
       memcpy(udpIn + 41 + (segsReceived * UDP_SEG_SIZE), buffer->data, len-3);
@@ -1033,7 +1091,7 @@ void espNowReceiveCB(uint8_t* address, uint8_t* data, uint8_t len, signed int rs
   if (!udpIn) return;
 
   packetsReceived++;
-  DEBUG_PRINTF_P(PSTR("ESP-NOW packet received: %d (%d/%d) s:[%d/%d]\n"), (int)buffer->packet, (int)packetsReceived, (int)buffer->noOfPackets, (int)segsReceived, MAX_NUM_SEGMENTS);
+  DEBUG_PRINTF_P(PSTR("ESP-NOW packet received: %d (%d/%d) s:[%d/%d]\n"), (int)buffer->packet, (int)packetsReceived, (int)buffer->noOfPackets, (int)segsReceived, UDP_MAX_SEGMENTS);
   if (packetsReceived >= buffer->noOfPackets) {
     // last packet received
     if (millis() - lastProcessed > 250) {
@@ -557,3 +557,79 @@ uint8_t get_random_wheel_index(uint8_t pos) {
 float mapf(float x, float in_min, float in_max, float out_min, float out_max) {
   return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
+
+/*
+ * Memory placement
+ * Large buffers are placed according to their tier (internal RAM or PSRAM) and accounted per owner.
+ * Every block carries a small header so it can be accounted when freed; blocks must be released with freeMem().
+ */
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_heap_caps.h>
+#if defined(CONFIG_SPIRAM) || defined(CONFIG_SPIRAM_SUPPORT)
+#include <soc/soc_memory_layout.h>
+#endif
+#endif
+
+typedef struct MemHeader {
+  uint32_t size;
+  uint8_t  owner;
+  bool     psram;
+  uint16_t magic;
+} mem_header_t; // 8 bytes, keeps returned block 8 byte aligned
+
+#define MEM_MAGIC 0x57A1
+
+static size_t memUsage[MEM_OWNERS][2]; // [owner][internal, PSRAM]
+
+bool isPSRAM(const void *ptr) {
+#if defined(ARDUINO_ARCH_ESP32) && (defined(CONFIG_SPIRAM) || defined(CONFIG_SPIRAM_SUPPORT))
+  return ptr && esp_ptr_external_ram(ptr);
+#else
+  return false;
+#endif
+}
+
+void *allocMem(size_t size, uint8_t tier, uint8_t owner) {
+  if (size == 0) return nullptr;
+  size_t total = size + sizeof(mem_header_t);
+  void *block = nullptr;
+#ifdef ARDUINO_ARCH_ESP32
+  if (psramSafe && psramFound()) {
+    constexpr uint32_t internal = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    constexpr uint32_t external = MALLOC_CAP_SPIRAM   | MALLOC_CAP_8BIT;
+    if (tier == MEM_AUTO) tier = size >= PSRAM_THRESHOLD ? MEM_BULK : MEM_HOT;
+    // hot data only goes to PSRAM if it would starve internal RAM
+    if (tier == MEM_HOT && heap_caps_get_free_size(internal) < total + MEM_INTERNAL_RESERVE) tier = MEM_BULK;
+    block = heap_caps_calloc(1, total, tier == MEM_BULK ? external : internal);
+    if (!block) block = heap_caps_calloc(1, total, tier == MEM_BULK ? internal : external); // fall back to other tier
+  } else
+#endif
+  block = calloc(1, total);
+  if (!block) {
+    DEBUG_PRINTF_P(PSTR("!!! Allocation of %uB failed (owner %d). !!!\n"), size, (int)owner);
+    return nullptr;
+  }
+  mem_header_t *hdr = static_cast<mem_header_t*>(block);
+  hdr->size  = size;
+  hdr->owner = owner < MEM_OWNERS ? owner : 0;
+  hdr->psram = isPSRAM(block);
+  hdr->magic = MEM_MAGIC;
+  memUsage[hdr->owner][hdr->psram] += size;
+  return hdr + 1;
+}
+
+void freeMem(void *ptr) {
+  if (!ptr) return;
+  mem_header_t *hdr = static_cast<mem_header_t*>(ptr) - 1;
+  if (hdr->magic != MEM_MAGIC) {
+    DEBUG_PRINTF_P(PSTR("!!! freeMem(%p): not allocated by allocMem(). !!!\n"), ptr);
+    return;
+  }
+  hdr->magic = 0; // catch double free
+  memUsage[hdr->owner][hdr->psram] -= hdr->size;
+  free(hdr);
+}
+
+size_t getMemUsage(uint8_t owner, bool psram) {
+  return owner < MEM_OWNERS ? memUsage[owner][psram] : 0;
+}
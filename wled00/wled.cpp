@@ -18,6 +18,53 @@ WLED::WLED()
 {
 }
 
+// periodic background tasks of the main loop (see scheduler.cpp)
+static void checkNodes()
+{
+  if (millis() - lastMqttReconnectAttempt > 30000 || lastMqttReconnectAttempt == 0) { // lastMqttReconnectAttempt==0 forces immediate broadcast
+    lastMqttReconnectAttempt = millis();
+    #ifndef WLED_DISABLE_MQTT
+    initMqtt();
+    #endif
+    yield();
+    // refresh WLED nodes list
+    refreshNodeList();
+    if (nodeBroadcastEnabled) sendSysInfoUDP();
+  }
+}
+
+// 15min PIN time-out
+static void checkPinTimeout()
+{
+  if (strlen(settingsPIN)>0 && correctPIN && millis() - lastEditTime > PIN_TIMEOUT) {
+    correctPIN = false;
+    createEditHandler(false);
+  }
+}
+
+// reconnect WiFi to clear stale allocations if heap gets too low
+static void checkHeap()
+{
+  static uint32_t lastHeap = UINT32_MAX;
+  uint32_t heap = ESP.getFreeHeap();
+  if (heap < MIN_HEAP_SIZE && lastHeap < MIN_HEAP_SIZE) {
+    DEBUG_PRINTF_P(PSTR("Heap too low! %u\n"), heap);
+    forceReconnect = true;
+    strip.resetSegments(); // remove all but one segments from memory
+  } else if (heap < MIN_HEAP_SIZE) {
+    DEBUG_PRINTLN(F("Heap low, purging segments."));
+    strip.purgeSegments();
+  }
+  lastHeap = heap;
+}
+
+#ifdef ESP8266
+static void handleMDNS()
+{
+  MDNS.update();
+}
+#endif
+
 // turns all LEDs off and restarts ESP
 void WLED::reset()
 {
@@ -36,8 +83,6 @@ void WLED::reset()
 
 void WLED::loop()
 {
-  static uint32_t      lastHeap = UINT32_MAX;
-  static unsigned long heapTime = 0;
 #ifdef WLED_DEBUG
   static unsigned long lastRun = 0;
   unsigned long        loopMillis = millis();
@@ -53,7 +98,7 @@ void WLED::loop()
   unsigned long        stripMillis;
 #endif
 
-  handleTime();
+  handleTime();      // keep time current before effects and timers use it
   #ifndef WLED_DISABLE_INFRARED
   handleIR();        // 2nd call to function needed for ESP32 to return valid results -- should be good for ESP8266, too
   #endif
@@ -64,6 +109,9 @@ void WLED::loop()
   handleImprovWifiScan();
   handleNotifications();
   handleTransitions();
+  #ifndef WLED_DISABLE_OTA
+  handleOTA();
+  #endif
   #ifdef WLED_ENABLE_DMX
   handleDMX();
   #endif
@@ -84,9 +132,6 @@ void WLED::loop()
   #ifndef WLED_DISABLE_INFRARED
   handleIR();
   #endif
-  #ifndef WLED_DISABLE_ALEXA
-  handleAlexa();
-  #endif
 
   if (doCloseFile) {
     closeFile();
@@ -127,10 +172,8 @@ void WLED::loop()
   if (stripMillis > maxStripMillis) maxStripMillis = stripMillis;
   #endif
 
-  yield();
-#ifdef ESP8266
-  MDNS.update();
-#endif
+  // background work in the slack before the next frame
+  handleTasks();
 
   //millis() rolls over every 50 days
   if (lastMqttReconnectAttempt > millis()) {
@@ -139,38 +182,6 @@ void WLED::loop()
     ntpLastSyncTime = NTP_NEVER;  // force new NTP query
     strip.restartRuntime();
   }
-  if (millis() - lastMqttReconnectAttempt > 30000 || lastMqttReconnectAttempt == 0) { // lastMqttReconnectAttempt==0 forces immediate broadcast
-    lastMqttReconnectAttempt = millis();
-    #ifndef WLED_DISABLE_MQTT
-    initMqtt();
-    #endif
-    yield();
-    // refresh WLED nodes list
-    refreshNodeList();
-    if (nodeBroadcastEnabled) sendSysInfoUDP();
-    yield();
-  }
-
-  // 15min PIN time-out
-  if (strlen(settingsPIN)>0 && correctPIN && millis() - lastEditTime > PIN_TIMEOUT) {
-    correctPIN = false;
-    createEditHandler(false);
-  }
-
-  // reconnect WiFi to clear stale allocations if heap gets too low
-  if (millis() - heapTime > 15000) {
-    uint32_t heap = ESP.getFreeHeap();
-    if (heap < MIN_HEAP_SIZE && lastHeap < MIN_HEAP_SIZE) {
-      DEBUG_PRINTF_P(PSTR("Heap too low! %u\n"), heap);
-      forceReconnect = true;
-      strip.resetSegments(); // remove all but one segments from memory
-    } else if (heap < MIN_HEAP_SIZE) {
-      DEBUG_PRINTLN(F("Heap low, purging segments."));
-      strip.purgeSegments();
-    }
-    lastHeap = heap;
-    heapTime = millis();
-  }
 
   //LED settings have been saved, re-init busses
   //This code block causes severe FPS drop on ESP32 with the original "if (busConfigs[0] != nullptr)" conditional. Investigate!
@@ -206,6 +217,7 @@ void WLED::loop()
     }
     #endif
     // create buses/outputs
+    const unsigned maxMem = BusManager::maxMemory();
     for (unsigned i = 0; i < WLED_MAX_BUSSES+WLED_MIN_VIRTUAL_BUSSES; i++) {
       if (busConfigs[i] == nullptr || (!useParallel && i > 10)) break;
       if (useParallel && i < 8) {
@@ -214,7 +226,7 @@ void WLED::loop()
         if (memT > mem) mem = memT; // if we have unequal LED count use the largest
       } else
         mem += BusManager::memUsage(*busConfigs[i]); // includes global buffer
-      if (mem <= MAX_LED_MEMORY) BusManager::add(*busConfigs[i]);
+      if (mem <= maxMem) BusManager::add(*busConfigs[i]);
       delete busConfigs[i];
       busConfigs[i] = nullptr;
     }
@@ -295,6 +307,10 @@ void WLED::loop()
       DEBUG_PRINTF_P(PSTR("UM time[ms]: %u/%lu\n"),   avgUsermodMillis/loops, maxUsermodMillis);
       DEBUG_PRINTF_P(PSTR("Strip time[ms]:%u/%lu\n"), avgStripMillis/loops,   maxStripMillis);
     }
+    for (unsigned i = 0; i < getTaskCount(); i++) {
+      const sched_task_t *t = getTask(i);
+      DEBUG_PRINTF_P(PSTR("Task %s: %u runs, %u deferred, time[us]: %u/%u\n"), t->name, t->runs, t->deferred, t->cost, t->maxCost);
+    }
     strip.printSize();
     loops = 0;
     maxLoopMillis = 0;
@@ -555,6 +571,19 @@ void WLED::setup()
 #endif
   random16_set_seed((uint16_t)((seed32 & 0xFFFF) ^ (seed32 >> 16)));
 
+  // main loop background tasks: name, period [ms], priority, estimated cost [us]
+  // (only periodic housekeeping that may be postponed to the slack after strip.service() is scheduled,
+  // handlers that must run every loop or before strip.service() are called directly from loop())
+  #ifndef WLED_DISABLE_ALEXA
+  addTask("alexa", handleAlexa,     0,     TASK_PRIO_LOW,  500);
+  #endif
+  #ifdef ESP8266
+  addTask("mdns",  handleMDNS,      0,     TASK_PRIO_LOW,  200);
+  #endif
+  addTask("nodes", checkNodes,      1000,  TASK_PRIO_LOW,  5000);
+  addTask("pin",   checkPinTimeout, 1000,  TASK_PRIO_LOW,  50);
+  addTask("heap",  checkHeap,       15000, TASK_PRIO_LOW,  50);
+
   #if WLED_WATCHDOG_TIMEOUT > 0
   enableWatchdog();
   #endif
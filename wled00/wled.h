@@ -879,7 +879,7 @@ WLED_GLOBAL WiFiUDP notifierUdp, rgbUdp, notifier2Udp;
 WLED_GLOBAL WiFiUDP ntpUdp;
 WLED_GLOBAL ESPAsyncE131 e131 _INIT_N(((handleE131Packet)));
 WLED_GLOBAL ESPAsyncE131 ddp  _INIT_N(((handleE131Packet)));
-WLED_GLOBAL bool e131NewData _INIT(false);
+WLED_GLOBAL bool e131NewData _INIT(false); // realtime data received but not yet shown (E1.31, DDP, UDP)
 
 // led fx library object
 WLED_GLOBAL BusManager busses _INIT(BusManager());
@@ -118,7 +118,7 @@ void handleSerial()
               JsonObject info  = pDoc->createNestedObject("info");
               serializeInfo(info);
 
-              serializeJson(*pDoc, Serial);
+              printStateJson(*pDoc, Serial);
               Serial.println();
             }
           }
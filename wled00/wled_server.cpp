@@ -10,6 +10,7 @@
   #include "html_pxmagic.h"
 #endif
 #include "html_cpal.h"
+#include "html_palettes.h"
 
 // define flash strings once (saves flash memory)
 static const char s_redirecting[] PROGMEM = "Redirecting...";
@@ -20,6 +21,11 @@ static const char s_notimplemented[] PROGMEM = "Not implemented";
 static const char s_accessdenied[]   PROGMEM = "Access Denied";
 static const char _common_js[]       PROGMEM = "/common.js";
 
+// state of an /update upload request (kept in request->_tempObject of the request that owns the update)
+#define OTA_REQ_ACTIVE 1
+#define OTA_REQ_DONE   2
+#define OTA_REQ_FAILED 3
+
 //Is this an IP?
 static bool isIp(String str) {
   for (size_t i = 0; i < str.length(); i++) {
@@ -176,7 +182,7 @@ static void handleUpload(AsyncWebServerRequest *request, const String& filename,
       doReboot = true;
       request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("Configuration restore successful.\nRebooting..."));
     } else {
-      if (filename.indexOf(F("palette")) >= 0 && filename.indexOf(F(".json")) >= 0) strip.loadCustomPalettes();
+      if (filename.indexOf(F("palette")) >= 0 && filename.indexOf(F(".json")) >= 0) strip.loadCustomPalettes(true); // uploaded file may have same size and time stamp
       request->send(200, FPSTR(CONTENT_TYPE_PLAIN), F("File Uploaded!"));
     }
     cacheInvalidate++;
@@ -335,6 +341,23 @@ void initServer()
   }, JSON_BUFFER_SIZE);
   server.addHandler(handler);
 
+  // binary per-LED upload (see applyPixelData()), body is collected into _tempObject like JSON requests
+  server.on(F("/pixels"), HTTP_POST, [](AsyncWebServerRequest *request) {
+    if (!request->_tempObject) {
+      serveJsonError(request, 413, ERR_NOBUF);
+      return;
+    }
+    if (!applyPixelData((const uint8_t*)request->_tempObject, request->contentLength())) {
+      serveJsonError(request, 400, ERR_JSON);
+      return;
+    }
+    request->send(200, CONTENT_TYPE_JSON, F("{\"success\":true}"));
+  }, nullptr, [](AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+    // worst case is RLE RGBW (5 bytes per LED) plus 5 byte header
+    if (!index && !request->_tempObject && total <= 5U + 5U * strip.getLengthTotal()) request->_tempObject = malloc(total);
+    if (request->_tempObject) memcpy((uint8_t*)request->_tempObject + index, data, len);
+  });
+
   server.on(F("/version"), HTTP_GET, [](AsyncWebServerRequest *request){
     request->send(200, FPSTR(CONTENT_TYPE_PLAIN), (String)VERSION);
   });
@@ -383,7 +406,8 @@ void initServer()
       serveMessage(request, 401, FPSTR(s_accessdenied), FPSTR(s_unlock_ota), 254);
       return;
     }
-    if (Update.hasError()) {
+    // only the request that started the update may report its result (another upload may be in progress)
+    if (!request->_tempObject || *(uint8_t*)request->_tempObject != OTA_REQ_DONE) {
       serveMessage(request, 500, F("Update failed!"), F("Please check your file and retry!"), 254);
     } else {
       serveMessage(request, 200, F("Update successful!"), F("Rebooting..."), 131);
@@ -391,32 +415,24 @@ void initServer()
     }
   },[](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final){
     if (!correctPIN || otaLock) return;
-    if(!index){
-      DEBUG_PRINTLN(F("OTA Update Start"));
-      #if WLED_WATCHDOG_TIMEOUT > 0
-      WLED::instance().disableWatchdog();
-      #endif
-      UsermodManager::onUpdateBegin(true); // notify usermods that update is about to begin (some may require task de-init)
-      lastEditTime = millis(); // make sure PIN does not lock during update
-      strip.suspend();
-      #ifdef ESP8266
-      strip.resetSegments();  // free as much memory as you can
-      Update.runAsync(true);
-      #endif
-      Update.begin((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
+    if (!index && !request->_tempObject) {
+      // optional SHA-256 of the image (hex) to verify before switching partitions, e.g. /update?sha256=...
+      const AsyncWebParameter *sha = request->getParam(F("sha256"));
+      if (!otaBegin(sha ? sha->value().c_str() : nullptr)) return; // rejected request never owns the update
+      request->_tempObject = malloc(1); // marks this request as owner of the update (freed with request)
+      if (!request->_tempObject) { otaAbort(); return; }
+      *(uint8_t*)request->_tempObject = OTA_REQ_ACTIVE;
+      request->onDisconnect([request](){
+        if (*(uint8_t*)request->_tempObject == OTA_REQ_ACTIVE) otaAbort(); // client went away before last chunk
+      });
     }
-    if(!Update.hasError()) Update.write(data, len);
-    if(final){
-      if(Update.end(true)){
-        DEBUG_PRINTLN(F("Update Success"));
-      } else {
-        DEBUG_PRINTLN(F("Update Failed"));
-        strip.resume();
-        UsermodManager::onUpdateBegin(false); // notify usermods that update has failed (some may require task init)
-        #if WLED_WATCHDOG_TIMEOUT > 0
-        WLED::instance().enableWatchdog();
-        #endif
-      }
+    uint8_t *state = (uint8_t*)request->_tempObject;
+    if (!state || *state != OTA_REQ_ACTIVE) return; // not the owner of the running update (or already failed)
+    if (!otaWrite(data, len)) {
+      otaAbort();
+      *state = OTA_REQ_FAILED;
+    } else if (final) {
+      *state = otaEnd() ? OTA_REQ_DONE : OTA_REQ_FAILED;
     }
   });
 #else
@@ -464,6 +480,11 @@ void initServer()
     handleStaticContent(request, FPSTR(_cpal_htm), 200, FPSTR(CONTENT_TYPE_HTML), PAGE_cpal, PAGE_cpal_L);
   });
 
+  // built-in palette previews (generated at build time from palettes.h), custom palettes are in /json/palx?page=-1
+  server.on(F("/palettes.json"), HTTP_GET, [](AsyncWebServerRequest *request) {
+    handleStaticContent(request, "", 200, FPSTR(CONTENT_TYPE_JSON), JSON_palettes, JSON_palettes_length, true, JSON_palettes_hash);
+  });
+
 #ifdef WLED_ENABLE_WEBSOCKETS
   server.addHandler(&ws);
 #endif
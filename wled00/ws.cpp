@@ -7,12 +7,109 @@
 
 uint16_t wsLiveClientId = 0;
 unsigned long wsLastLiveTime = 0;
-//uint8_t* wsFrameBuffer = nullptr;
+
+// reassembly of fragmented/split messages (one client at a time)
+static uint8_t *wsFrameBuffer = nullptr;
+static size_t   wsFrameLen = 0;
+static size_t   wsFrameSize = 0;      // allocated size of wsFrameBuffer
+static uint32_t wsFrameClientId = 0;
+static unsigned long wsFrameTime = 0; // last fragment received
+static bool     wsFrameOverflow = false;
 
 #define WS_LIVE_INTERVAL 40
+#ifndef WS_MAX_MESSAGE_SIZE
+  #define WS_MAX_MESSAGE_SIZE JSON_BUFFER_SIZE // largest reassembled message we accept
+#endif
+#define WS_FRAME_TIMEOUT 3000 // ms after which an incomplete message is dropped and another client may send
+
+static void wsFreeFrameBuffer()
+{
+  free(wsFrameBuffer);
+  wsFrameBuffer = nullptr;
+  wsFrameLen = 0;
+  wsFrameSize = 0;
+  wsFrameClientId = 0;
+  wsFrameOverflow = false;
+}
+
+// grows reassembly buffer to hold size bytes, drops collected data if message is too large
+static bool wsReserveFrameBuffer(size_t size)
+{
+  if (size <= wsFrameSize) return true;
+  uint8_t *buf = size <= WS_MAX_MESSAGE_SIZE ? (uint8_t*)realloc(wsFrameBuffer, size) : nullptr;
+  if (buf) {
+    wsFrameBuffer = buf;
+    wsFrameSize = size;
+    return true;
+  }
+  DEBUG_PRINTLN(F("WS message too large."));
+  free(wsFrameBuffer); // keep client ID so remaining fragments are dropped
+  wsFrameBuffer = nullptr;
+  wsFrameLen = 0;
+  wsFrameSize = 0;
+  wsFrameOverflow = true;
+  return false;
+}
+
+// handles a complete (possibly reassembled) message
+static void wsHandleMessage(AsyncWebSocketClient * client, uint8_t opcode, uint8_t *data, size_t len)
+{
+  if (opcode == WS_BINARY) {
+    // binary per-LED upload, no JSON buffer needed (see applyPixelData())
+    if (!applyPixelData(data, len)) client->text(F("{\"error\":9}")); // ERR_JSON malformed frame
+    return;
+  }
+  if (opcode != WS_TEXT) return;
+
+  if (len > 0 && len < 10 && data[0] == 'p') {
+    // application layer ping/pong heartbeat.
+    // client-side socket layer ping packets are unanswered (investigate)
+    client->text(F("pong"));
+    return;
+  }
+
+  bool verboseResponse = false;
+  if (!requestJSONBufferLock(11)) {
+    client->text(F("{\"error\":3}")); // ERR_NOBUF
+    return;
+  }
+
+  DeserializationError error = deserializeJson(*pDoc, data, len);
+  JsonObject root = pDoc->as<JsonObject>();
+  if (error || root.isNull()) {
+    releaseJSONBufferLock();
+    return;
+  }
+  if (root["v"] && root.size() == 1) {
+    //if the received value is just "{"v":true}", send only to this client
+    verboseResponse = true;
+  } else if (root.containsKey("lv")) {
+    wsLiveClientId = root["lv"] ? client->id() : 0;
+  } else {
+    verboseResponse = deserializeState(root);
+  }
+  releaseJSONBufferLock();
+
+  if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
+    if (verboseResponse) {
+      sendDataWs(client);
+    } else {
+      // we have to send something back otherwise WS connection closes
+      client->text(F("{\"success\":true}"));
+    }
+    // force broadcast in 500ms after updating client
+    //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
+  }
+}
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
+  // release message of a client that stopped sending fragments (checked here as buffer is only touched by WS events)
+  if (wsFrameClientId && millis() - wsFrameTime > WS_FRAME_TIMEOUT) {
+    DEBUG_PRINTLN(F("WS multipart message timed out."));
+    wsFreeFrameBuffer();
+  }
+
   if(type == WS_EVT_CONNECT){
     //client connected
     DEBUG_PRINTLN(F("WS client connected."));
@@ -20,71 +117,44 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    if (client->id() == wsFrameClientId) wsFreeFrameBuffer();
     DEBUG_PRINTLN(F("WS client disconnected."));
   } else if(type == WS_EVT_DATA){
     // data packet
     AwsFrameInfo * info = (AwsFrameInfo*)arg;
     if(info->final && info->index == 0 && info->len == len){
       // the whole message is in a single frame and we got all of its data (max. 1450 bytes)
-      if(info->opcode == WS_TEXT)
-      {
-        if (len > 0 && len < 10 && data[0] == 'p') {
-          // application layer ping/pong heartbeat.
-          // client-side socket layer ping packets are unanswered (investigate)
-          client->text(F("pong"));
-          return;
-        }
-
-        bool verboseResponse = false;
-        if (!requestJSONBufferLock(11)) {
-          client->text(F("{\"error\":3}")); // ERR_NOBUF
+      wsHandleMessage(client, info->opcode, data, len);
+    } else {
+      //message is comprised of multiple frames or the frame is split into multiple packets
+      bool first = (info->num == 0 && info->index == 0);
+      bool last  = (info->final && (info->index + len) == info->len);
+      if (first) {
+        if (wsFrameClientId && wsFrameClientId != client->id()) {
+          // another client is still assembling its message, ask this one to retry later
+          if (last) client->text(F("{\"error\":2}")); // ERR_CONCURRENCY
+          else      client->close(1013); // try again later
           return;
         }
+        wsFreeFrameBuffer();
+        wsFrameClientId = client->id();
+      } else if (wsFrameClientId != client->id()) return; // continuation of a rejected (or timed out) message
+      wsFrameTime = millis();
 
-        DeserializationError error = deserializeJson(*pDoc, data, len);
-        JsonObject root = pDoc->as<JsonObject>();
-        if (error || root.isNull()) {
-          releaseJSONBufferLock();
-          return;
-        }
-        if (root["v"] && root.size() == 1) {
-          //if the received value is just "{"v":true}", send only to this client
-          verboseResponse = true;
-        } else if (root.containsKey("lv")) {
-          wsLiveClientId = root["lv"] ? client->id() : 0;
-        } else {
-          verboseResponse = deserializeState(root);
-        }
-        releaseJSONBufferLock();
-
-        if (!interfaceUpdateCallMode) { // individual client response only needed if no WS broadcast soon
-          if (verboseResponse) {
-            sendDataWs(client);
-          } else {
-            // we have to send something back otherwise WS connection closes
-            client->text(F("{\"success\":true}"));
-          }
-          // force broadcast in 500ms after updating client
-          //lastInterfaceUpdate = millis() - (INTERFACE_UPDATE_COOLDOWN -500); // ESP8266 does not like this
-        }
+      // frame length is known from its first packet: allocate once per frame instead of once per packet
+      if (!wsFrameOverflow && info->index == 0) wsReserveFrameBuffer(wsFrameLen + info->len);
+      if (!wsFrameOverflow && len && wsReserveFrameBuffer(wsFrameLen + len)) {
+        memcpy(wsFrameBuffer + wsFrameLen, data, len);
+        wsFrameLen += len;
       }
-    } else {
-      //message is comprised of multiple frames or the frame is split into multiple packets
-      //if(info->index == 0){
-        //if (!wsFrameBuffer && len < 4096) wsFrameBuffer = new uint8_t[4096];
-      //}
 
-      //if (wsFrameBuffer && len < 4096 && info->index + info->)
-      //{
-
-      //}
-
-      if((info->index + len) == info->len){
-        if(info->final){
-          if(info->message_opcode == WS_TEXT) {
-            client->text(F("{\"error\":9}")); // ERR_JSON we do not handle split packets right now
-          }
+      if (last) {
+        if (wsFrameOverflow) {
+          client->text(info->message_opcode == WS_TEXT ? F("{\"error\":9}") : F("{\"error\":3}")); // ERR_JSON / ERR_NOBUF
+        } else {
+          wsHandleMessage(client, info->message_opcode, wsFrameBuffer, wsFrameLen);
         }
+        wsFreeFrameBuffer();
       }
       DEBUG_PRINTLN(F("WS multipart message."));
     }
@@ -120,7 +190,7 @@ void sendDataWs(AsyncWebSocketClient * client)
   JsonObject info  = pDoc->createNestedObject("info");
   serializeInfo(info);
 
-  size_t len = measureJson(*pDoc);
+  size_t len = measureStateJson(*pDoc);
   DEBUG_PRINTF_P(PSTR("JSON buffer size: %u for WS request (%u).\n"), pDoc->memoryUsage(), len);
 
   // the following may no longer be necessary as heap management has been fixed by @willmmiles in AWS
@@ -146,7 +216,7 @@ void sendDataWs(AsyncWebSocketClient * client)
     ws.cleanupClients(0); //disconnect all clients to release memory
     return; //out of memory
   }
-  serializeJson(*pDoc, (char *)buffer.data(), len);
+  serializeStateJson(*pDoc, (char *)buffer.data(), len);
 
   DEBUG_PRINT(F("Sending WS data "));
   if (client) {
@@ -270,7 +270,7 @@ void getSettingsJS(byte subPage, Print& settingsScript)
       WLED_MAX_BUSSES,
       WLED_MIN_VIRTUAL_BUSSES,
       MAX_LEDS_PER_BUS,
-      MAX_LED_MEMORY,
+      (int)BusManager::maxMemory(),
       MAX_LEDS,
       WLED_MAX_COLOR_ORDER_MAPPINGS,
       WLED_MAX_DIGITAL_CHANNELS,